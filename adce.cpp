@@ -0,0 +1,85 @@
+#include "adce.hpp"
+
+namespace YAOPT {
+
+namespace {
+
+// An alloca whose every use is the address of a store is written but never read.
+[[nodiscard]] bool writeOnly(SSA& ssa, AllocaInst* alloca) {
+    bool result = true;
+    ssa.forEachUse(alloca->number, [&](SSA::Use const& use) {
+        auto store = dyn_cast<StoreInst>(use.user);
+        result &= store && use.value == &store->into;
+    });
+    return result;
+}
+
+}
+
+PassResult adce(FunctionDefine& define) {
+    if (define.bbs.empty()) return {};
+    auto& ssa = define.ssa;
+    size_t removed = 0;
+    auto& cfg = define.cfg();
+    for (auto bb : define.bbs) {
+        if (cfg.reachable(bb->index)) continue;
+        for ([[maybe_unused]] auto inst : bb->insts) ++removed;
+    }
+    bool control = removeBlocks(define, [&](BasicBlock const* bb) { return !cfg.reachable(bb->index); });
+
+    std::vector<bool> deadAlloca(ssa.size()), live(ssa.size());
+    for (auto bb : define.bbs) {
+        for (auto inst : bb->insts) {
+            if (auto alloca = dyn_cast<AllocaInst>(inst); alloca && alloca->number != Value::NONE) {
+                deadAlloca[alloca->number] = writeOnly(ssa, alloca);
+            }
+        }
+    }
+    auto root = [&](Inst* inst) {
+        if (inst->kind() != Inst::Kind::INTERMEDIATE) return true;
+        if (dyn_cast<CallInst>(inst)) return true;
+        if (auto store = dyn_cast<StoreInst>(inst)) {
+            return store->into.reg == Value::NONE || !deadAlloca[ssa.find(store->into.reg)];
+        }
+        return false;
+    };
+
+    std::vector<uint32_t> work;
+    auto mark = [&](Inst* inst) {
+        inst->forEachOperand([&](Value& value) {
+            if (value.reg == Value::NONE) return;
+            uint32_t reg = ssa.find(value.reg);
+            if (live[reg]) return;
+            live[reg] = true;
+            work.push_back(reg);
+        });
+    };
+    for (auto bb : define.bbs) {
+        for (auto inst : bb->insts) {
+            if (root(inst)) mark(inst);
+        }
+    }
+    while (!work.empty()) {
+        uint32_t reg = work.back();
+        work.pop_back();
+        if (auto def = ssa.slots[reg].def) mark(def);
+    }
+
+    for (auto bb : define.bbs) {
+        for (auto it = bb->insts.begin(); it != bb->insts.end();) {
+            auto inst = *it;
+            ++it;
+            if (root(inst)) continue;
+            uint32_t number = static_cast<IntermediateInst*>(inst)->number;
+            if (number != Value::NONE && live[number]) continue;
+            ssa.drop(inst);
+            bb->insts.erase(inst);
+            ++removed;
+        }
+    }
+    if (!removed) return {};
+    ssa.flush();
+    return {removed, control ? Changed::CONTROL : Changed::VALUES};
+}
+
+}
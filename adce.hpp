@@ -0,0 +1,12 @@
+#pragma once
+
+#include "entity.hpp"
+
+namespace YAOPT {
+
+// Aggressive dead code elimination: deletes blocks unreachable from the entry, then keeps only what stores,
+// calls and terminators transitively depend on. Allocas that are never loaded go together with their stores.
+// Reports the number of instructions it removed.
+PassResult adce(FunctionDefine& define);
+
+}
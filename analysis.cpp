@@ -0,0 +1,46 @@
+#include "analysis.hpp"
+#include "entity.hpp"
+
+namespace YAOPT {
+
+CFG const& AnalysisCache::cfg(FunctionDefine const& define) {
+    if (!graph) {
+        graph = std::make_unique<CFG>(define);
+        ++computed[size_t(Analysis::CFG)];
+    }
+    return *graph;
+}
+
+DomTree const& AnalysisCache::dominators(FunctionDefine const& define) {
+    if (!tree) {
+        tree = std::make_unique<DomTree>(cfg(define));
+        ++computed[size_t(Analysis::DOMINATORS)];
+    }
+    return *tree;
+}
+
+LoopInfo const& AnalysisCache::loops(FunctionDefine const& define) {
+    if (!nest) {
+        nest = std::make_unique<LoopInfo>(cfg(define), dominators(define));
+        ++computed[size_t(Analysis::LOOPS)];
+    }
+    return *nest;
+}
+
+Liveness const& AnalysisCache::liveness(FunctionDefine const& define) {
+    if (!live) {
+        live = std::make_unique<Liveness>(define);
+        ++computed[size_t(Analysis::LIVENESS)];
+    }
+    return *live;
+}
+
+ReachingStores const& AnalysisCache::reachingStores(FunctionDefine const& define) {
+    if (!stores) {
+        stores = std::make_unique<ReachingStores>(define);
+        ++computed[size_t(Analysis::REACHING_STORES)];
+    }
+    return *stores;
+}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include "cfg.hpp"
+#include "dom.hpp"
+#include "dataflow.hpp"
+#include "loop.hpp"
+
+namespace YAOPT {
+
+struct FunctionDefine;
+
+// How much of a function a pass touched; each level implies the ones before it. VALUES covers instructions
+// and operands inside blocks, CONTROL also covers the blocks themselves, their order and their edges.
+enum class Changed : uint8_t {
+    NOTHING, VALUES, CONTROL
+};
+
+struct PassResult {
+    size_t changes = 0;
+    Changed changed = Changed::NOTHING;
+};
+
+enum class Analysis : uint8_t {
+    CFG, DOMINATORS, LOOPS, LIVENESS, REACHING_STORES, COUNT
+};
+
+constexpr std::string_view ANALYSIS_NAME[] = {"cfg", "dominators", "loops", "liveness", "reaching-stores"};
+
+static_assert(std::size(ANALYSIS_NAME) == size_t(Analysis::COUNT));
+
+// Lazily computed analyses of one function. An analysis is dropped only by a change at or above the level
+// it reads: the CFG, the dominator tree and the loops survive VALUES, liveness and reaching stores do not.
+struct AnalysisCache {
+    size_t computed[size_t(Analysis::COUNT)] = {};
+
+    [[nodiscard]] CFG const& cfg(FunctionDefine const& define);
+    [[nodiscard]] DomTree const& dominators(FunctionDefine const& define);
+    [[nodiscard]] LoopInfo const& loops(FunctionDefine const& define);
+    [[nodiscard]] Liveness const& liveness(FunctionDefine const& define);
+    [[nodiscard]] ReachingStores const& reachingStores(FunctionDefine const& define);
+
+    void invalidate(Changed changed) noexcept {
+        if (changed >= Changed::CONTROL) {
+            graph.reset();
+            tree.reset();
+            nest.reset();
+        }
+        if (changed >= Changed::VALUES) {
+            live.reset();
+            stores.reset();
+        }
+    }
+
+private:
+    std::unique_ptr<CFG> graph;
+    std::unique_ptr<DomTree> tree;
+    std::unique_ptr<LoopInfo> nest;
+    std::unique_ptr<Liveness> live;
+    std::unique_ptr<ReachingStores> stores;
+};
+
+}
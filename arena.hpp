@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace YAOPT {
+
+struct Arena {
+    Arena() = default;
+    Arena(Arena const&) = delete;
+    Arena& operator=(Arena const&) = delete;
+    Arena(Arena&& other) noexcept:
+            blocks(std::exchange(other.blocks, nullptr)),
+            finalizers(std::exchange(other.finalizers, nullptr)),
+            cursor(std::exchange(other.cursor, nullptr)),
+            limit(std::exchange(other.limit, nullptr)),
+            reserved(std::exchange(other.reserved, 0)) {}
+    ~Arena() {
+        release();
+    }
+
+    void* allocate(size_t size, size_t align) {
+        auto p = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(cursor) + align - 1) & ~(align - 1));
+        if (!cursor || p + size > limit) {
+            grow(size + align);
+            p = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(cursor) + align - 1) & ~(align - 1));
+        }
+        cursor = p + size;
+        return p;
+    }
+
+    template<typename T, typename... Args>
+    T* make(Args&&... args) {
+        T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        finalize(object, 1);
+        return object;
+    }
+
+    template<typename T>
+    std::span<T> array(std::span<const T> values) {
+        if (values.empty()) return {};
+        T* data = static_cast<T*>(allocate(sizeof(T) * values.size(), alignof(T)));
+        std::uninitialized_copy(values.begin(), values.end(), data);
+        finalize(data, values.size());
+        return {data, values.size()};
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept {
+        return reserved;
+    }
+
+    void release() noexcept {
+        for (auto f = finalizers; f; f = f->next) {
+            f->destroy(f->object, f->count);
+        }
+        finalizers = nullptr;
+        while (blocks) {
+            std::free(std::exchange(blocks, blocks->prev));
+        }
+        cursor = limit = nullptr;
+        reserved = 0;
+    }
+
+private:
+    struct Block {
+        Block* prev;
+    };
+    struct Finalizer {
+        void (*destroy)(void*, size_t);
+        void* object;
+        size_t count;
+        Finalizer* next;
+    };
+
+    static constexpr size_t MIN_BLOCK = 4096, MAX_BLOCK = 1 << 20;
+
+    Block* blocks = nullptr;
+    Finalizer* finalizers = nullptr;
+    char* cursor = nullptr;
+    char* limit = nullptr;
+    size_t reserved = 0;
+
+    template<typename T>
+    void finalize(T* objects, size_t count) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            finalizers = new (allocate(sizeof(Finalizer), alignof(Finalizer))) Finalizer{
+                [](void* p, size_t n) { std::destroy_n(static_cast<T*>(p), n); }, objects, count, finalizers};
+        }
+    }
+
+    void grow(size_t least) {
+        size_t size = std::max(least + sizeof(Block), std::clamp(reserved, MIN_BLOCK, MAX_BLOCK));
+        auto block = static_cast<Block*>(std::malloc(size));
+        if (!block) throw std::bad_alloc();
+        block->prev = blocks;
+        blocks = block;
+        cursor = reinterpret_cast<char*>(block + 1);
+        limit = reinterpret_cast<char*>(block) + size;
+        reserved += size;
+    }
+};
+
+}
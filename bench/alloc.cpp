@@ -0,0 +1,83 @@
+#include "bench.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef __unix__
+#include <sys/resource.h>
+#endif
+
+namespace YAOPT::Bench {
+
+static std::atomic<size_t> counter = 0;
+
+size_t allocations() noexcept {
+    return counter.load(std::memory_order_relaxed);
+}
+
+// Linux keeps the high-water mark in /proc and lets it be reset; elsewhere the process-wide peak is all there is.
+static size_t statusKB(const char* field) {
+    size_t value = 0;
+    if (FILE* status = fopen("/proc/self/status", "r")) {
+        char line[256];
+        size_t length = strlen(field);
+        while (fgets(line, sizeof line, status)) {
+            if (!strncmp(line, field, length)) {
+                value = strtoull(line + length, nullptr, 10);
+                break;
+            }
+        }
+        fclose(status);
+    }
+    return value;
+}
+
+size_t peakRSS() noexcept {
+    if (size_t kb = statusKB("VmHWM:")) return kb << 10;
+#ifdef __unix__
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return size_t(usage.ru_maxrss) << 10;
+#else
+    return 0;
+#endif
+}
+
+size_t resetPeakRSS() noexcept {
+    if (FILE* refs = fopen("/proc/self/clear_refs", "w")) {
+        fputs("5", refs);
+        fclose(refs);
+    }
+    return statusKB("VmRSS:") << 10;
+}
+
+}
+
+void* operator new(size_t size) {
+    YAOPT::Bench::counter.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
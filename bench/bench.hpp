@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+
+namespace YAOPT::Bench {
+
+struct Suite {
+    const char* name;
+    void (*run)();
+};
+
+template<typename F>
+double measure(F&& body, double budget = 0.25) {
+    using clock = std::chrono::steady_clock;
+    double best = 1e300, total = 0;
+    do {
+        auto start = clock::now();
+        body();
+        double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        best = std::min(best, elapsed);
+        total += elapsed;
+    } while (total < budget);
+    return best;
+}
+
+size_t allocations() noexcept;
+size_t peakRSS() noexcept;
+// Restarts the peak RSS from the current RSS where the platform allows it, and returns the current RSS.
+size_t resetPeakRSS() noexcept;
+
+inline void report(std::string_view name, double seconds, size_t bytes) {
+    printf("%-48.*s %10.3f ms %12.1f MB/s\n", int(name.length()), name.data(), seconds * 1e3, bytes / seconds / 1e6);
+}
+
+inline void report(std::string_view name, double seconds, size_t count, const char* unit) {
+    printf("%-48.*s %10.3f ms %12zu %s\n", int(name.length()), name.data(), seconds * 1e3, count, unit);
+}
+
+inline void report(std::string_view name, double seconds, size_t bytes, size_t insts, size_t rss, size_t peak) {
+    printf("%-48.*s %10.3f ms %10.1f MB/s %10.2f Minst/s %8.1f MB peak (+%.1f MB)\n", int(name.length()), name.data(),
+           seconds * 1e3, bytes / seconds / 1e6, insts / seconds / 1e6, peak / 1048576.0, (peak > rss ? peak - rss : 0) / 1048576.0);
+}
+
+template<typename T>
+inline void keep(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}
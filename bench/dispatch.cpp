@@ -0,0 +1,128 @@
+#include "bench.hpp"
+
+#include "../parser.hpp"
+
+#include <random>
+#include <string>
+
+namespace YAOPT::Bench {
+
+// One large function where every block cycles through a random mix of every instruction class.
+static std::string mixedFunction(size_t blocks, uint64_t seed) {
+    static constexpr const char* INSTS[] = {
+        "%r = add i64 %arg, 1",
+        "%r = fadd double 1.0, 2.0",
+        "%r = fneg double 1.0",
+        "%r = icmp slt i64 %arg, 50",
+        "%r = fcmp olt double 1.0, 2.0",
+        "%r = sitofp i64 %arg to double",
+        "%r = alloca i64",
+        "%r = load i64, ptr %p",
+        "store i64 %arg, ptr %p",
+        "%r = getelementptr inbounds i64, ptr %p, i64 1",
+        "call void @print(i64 %arg)",
+    };
+    std::mt19937_64 random(seed);
+    std::string buf = "declare void @print(i64)\n\ndefine void @f(i64 %arg, ptr %p) {\n";
+    size_t reg = 0;
+    for (size_t b = 0; b < blocks; ++b) {
+        buf += "L" + std::to_string(b) + ":\n";
+        if (b) buf += "    %" + std::to_string(reg++) + " = phi i64 [ %arg, %L" + std::to_string(b - 1) + " ]\n";
+        for (size_t i = 0; i < 16; ++i) {
+            std::string inst = INSTS[random() % std::size(INSTS)];
+            if (inst.starts_with("%r")) inst.replace(1, 1, std::to_string(reg++));
+            buf += "    " + inst + "\n";
+        }
+        if (b + 1 == blocks) {
+            buf += "    ret void\n";
+        } else if (random() % 2) {
+            buf += "    br label %L" + std::to_string(b + 1) + "\n";
+        } else {
+            buf += "    %" + std::to_string(reg) + " = icmp eq i64 %arg, 0\n";
+            buf += "    br i1 %" + std::to_string(reg++) + ", label %L" + std::to_string(b + 1) + ", label %L" + std::to_string(b + 1) + "\n";
+        }
+    }
+    return buf + "}\n";
+}
+
+// Classifies each instruction with the if-chain the passes use, in the order they test it.
+template<template<typename> typename As>
+static size_t chain(Inst* inst) {
+    if (As<PhiInst>::of(inst)) return 1;
+    if (As<BinaryOpInst>::of(inst)) return 2;
+    if (As<UnaryOpInst>::of(inst)) return 3;
+    if (As<IcmpInst>::of(inst)) return 4;
+    if (As<FcmpInst>::of(inst)) return 5;
+    if (As<ConvInst>::of(inst)) return 6;
+    if (As<AllocaInst>::of(inst)) return 7;
+    if (As<LoadInst>::of(inst)) return 8;
+    if (As<StoreInst>::of(inst)) return 9;
+    if (As<GEPInst>::of(inst)) return 10;
+    if (As<CallInst>::of(inst)) return 11;
+    if (As<RetInst>::of(inst)) return 12;
+    if (As<BrLabelInst>::of(inst)) return 13;
+    if (As<BrCondInst>::of(inst)) return 14;
+    if (As<UnreachableInst>::of(inst)) return 15;
+    return 0;
+}
+
+template<typename T>
+struct DynamicCast {
+    static T* of(Inst* inst) { return dynamic_cast<T*>(inst); }
+};
+
+template<typename T>
+struct DynCast {
+    static T* of(Inst* inst) { return dyn_cast<T>(inst); }
+};
+
+struct Classify {
+    size_t operator()(LabelInst*) const { return 0; }
+    size_t operator()(PhiInst*) const { return 1; }
+    size_t operator()(BinaryOpInst*) const { return 2; }
+    size_t operator()(UnaryOpInst*) const { return 3; }
+    size_t operator()(IcmpInst*) const { return 4; }
+    size_t operator()(FcmpInst*) const { return 5; }
+    size_t operator()(ConvInst*) const { return 6; }
+    size_t operator()(AllocaInst*) const { return 7; }
+    size_t operator()(LoadInst*) const { return 8; }
+    size_t operator()(StoreInst*) const { return 9; }
+    size_t operator()(GEPInst*) const { return 10; }
+    size_t operator()(CallInst*) const { return 11; }
+    size_t operator()(RetInst*) const { return 12; }
+    size_t operator()(BrLabelInst*) const { return 13; }
+    size_t operator()(BrCondInst*) const { return 14; }
+    size_t operator()(UnreachableInst*) const { return 15; }
+};
+
+// Dispatch cost on one large function: the dynamic_cast chains the passes were written with, the same
+// chains over the opcode tag, and visit(), which switches on the tag once.
+void dispatchSuite() {
+    Parser parser(Input{mixedFunction(1 << 14, 42)});
+    parser.tokenize();
+    parser.parse();
+    std::vector<Inst*> insts;
+    for (auto&& entity : parser.entities) {
+        if (auto define = dynamic_cast<FunctionDefine*>(entity.get())) {
+            for (auto bb : define->bbs) {
+                for (auto inst : bb->insts) insts.push_back(inst);
+            }
+        }
+    }
+    size_t expected = 0, sum = 0;
+    for (auto inst : insts) expected += chain<DynamicCast>(inst);
+    auto run = [&](std::string_view name, auto&& classify) {
+        double seconds = measure([&] {
+            sum = 0;
+            for (auto inst : insts) sum += classify(inst);
+            keep(sum);
+        });
+        report(name, seconds, insts.size(), "insts");
+        if (sum != expected) printf("%-48.*s disagrees: %zu != %zu\n", int(name.length()), name.data(), sum, expected);
+    };
+    run("dispatch/dynamic_cast chain", [](Inst* inst) { return chain<DynamicCast>(inst); });
+    run("dispatch/dyn_cast chain", [](Inst* inst) { return chain<DynCast>(inst); });
+    run("dispatch/visit", [](Inst* inst) { return visit(inst, Classify{}); });
+}
+
+}
@@ -0,0 +1,52 @@
+#include "bench.hpp"
+
+#include "../dom.hpp"
+
+#include <random>
+#include <string>
+
+namespace YAOPT::Bench {
+
+// Structured-ish random graph: a spanning tree with local parents plus forward and back edges, about two successors per block.
+static CFG randomCFG(uint32_t size, uint64_t seed) {
+    std::mt19937_64 random(seed);
+    std::vector<CFG::Edge> edges;
+    edges.reserve(size * 2);
+    for (uint32_t i = 1; i < size; ++i) {
+        edges.emplace_back(i - 1 - random() % std::min<uint32_t>(i, 4), i);
+    }
+    for (uint32_t i = 0; i < size; ++i) {
+        uint32_t span = 1 + random() % 64;
+        if (random() % 4 == 0) {
+            edges.emplace_back(i, i >= span ? i - span : 0);
+        } else if (i + span < size) {
+            edges.emplace_back(i, i + span);
+        }
+    }
+    return {size, edges};
+}
+
+void domSuite() {
+    for (uint32_t size : {16u, 100u, 1000u, 10000u, 100000u, 1000000u}) {
+        CFG cfg = randomCFG(size, size);
+        std::string scale = std::to_string(size);
+        double budget = size >= 1000000 ? 1.0 : 0.25;
+        double iterative = measure([&] { keep(DomTree(cfg, DomTree::Algorithm::ITERATIVE)); }, budget);
+        double semiNCA = measure([&] { keep(DomTree(cfg, DomTree::Algorithm::SEMI_NCA)); }, budget);
+        report("dom/iterative x " + scale, iterative, size, "blocks");
+        report("dom/semi-nca x " + scale, semiNCA, size, "blocks");
+        DomTree tree(cfg, DomTree::Algorithm::SEMI_NCA);
+        if (tree.idom != DomTree(cfg, DomTree::Algorithm::ITERATIVE).idom) {
+            printf("dom/%u: algorithms disagree\n", size);
+        }
+        report("dom/frontier x " + scale, measure([&] { keep(DomFrontier(cfg, tree)); }, budget), size, "blocks");
+        size_t dominated = 0;
+        report("dom/dominates x " + scale, measure([&] {
+            dominated = 0;
+            for (uint32_t b = 0; b < size; ++b) dominated += tree.dominates(b / 2, b);
+        }, budget), size, "queries");
+        keep(dominated);
+    }
+}
+
+}
@@ -0,0 +1,104 @@
+#include "generator.hpp"
+
+#include "../dom.hpp"
+
+#include <charconv>
+#include <random>
+#include <vector>
+
+namespace YAOPT::Bench {
+
+std::string generateModule(ModuleShape const& shape) {
+    static constexpr const char* OPS[] = {"add", "sub", "mul", "and", "or", "xor"};
+    std::mt19937_64 random(shape.seed);
+    std::string buf;
+    buf += "@counter = global i64 0\n";
+    buf += "declare void @print(i64)\n\n";
+    uint32_t blocks = std::max<size_t>(shape.blocks, 1);
+    std::vector<CFG::Edge> edges;
+    std::vector<uint32_t> targets(blocks);
+    std::vector<size_t> regs, begin(blocks), end(blocks);
+    for (size_t f = 0; f < shape.functions; ++f) {
+        // Shape the CFG first so that operands can be drawn from dominating blocks only.
+        edges.clear();
+        for (uint32_t b = 0; b + 1 < blocks; ++b) {
+            targets[b] = CFG::NONE;
+            edges.emplace_back(b, b + 1);
+            if (random() % 100 < shape.branches) {
+                targets[b] = b + 1 + random() % (blocks - 1 - b);
+                edges.emplace_back(b, targets[b]);
+            }
+        }
+        DomTree tree(CFG(blocks, edges));
+
+        regs.clear();
+        size_t reg = 0;
+        auto operand = [&](uint32_t block) -> std::string {
+            if (!shape.fanout) return "%arg";
+            for (size_t k = random() % shape.fanout;;) {
+                size_t available = end[block] - begin[block];
+                if (k < available) return "%" + std::to_string(regs[end[block] - 1 - k]);
+                k -= available;
+                if (block == tree.root) return "%arg";
+                block = tree.idom[block];
+            }
+        };
+        buf += "define i64 @f" + std::to_string(f) + "(i64 %arg) {\n";
+        for (uint32_t b = 0; b < blocks; ++b) {
+            begin[b] = end[b] = regs.size();
+            buf += "L" + std::to_string(b) + ":\n";
+            for (size_t i = 0; i < shape.insts; ++i) {
+                auto lhs = operand(b);
+                auto rhs = random() % 2 ? operand(b) : std::to_string(random() % 100);
+                buf += "    %" + std::to_string(reg) + " = " + OPS[random() % std::size(OPS)] + " i64 " + lhs + ", " + rhs + "\n";
+                regs.push_back(reg++);
+                end[b] = regs.size();
+            }
+            if (b + 1 == blocks) {
+                buf += "    ret i64 " + operand(b) + "\n";
+            } else if (targets[b] == CFG::NONE) {
+                buf += "    br label %L" + std::to_string(b + 1) + "\n";
+            } else {
+                buf += "    %" + std::to_string(reg) + " = icmp slt i64 " + operand(b) + ", 50\n";
+                buf += "    br i1 %" + std::to_string(reg) + ", label %L" + std::to_string(b + 1)
+                        + ", label %L" + std::to_string(targets[b]) + "\n";
+                ++reg;
+            }
+        }
+        buf += "}\n\n";
+    }
+    return buf;
+}
+
+bool setKnob(ModuleShape& shape, std::string_view arg) {
+    auto eq = arg.find('=');
+    if (eq == arg.npos) return false;
+    auto name = arg.substr(0, eq), text = arg.substr(eq + 1);
+    uint64_t value;
+    if (auto [ptr, ec] = std::from_chars(text.begin(), text.end(), value); ec != std::errc{} || ptr != text.end()) {
+        return false;
+    }
+    if (name == "functions") {
+        shape.functions = value;
+    } else if (name == "blocks") {
+        shape.blocks = value;
+    } else if (name == "insts") {
+        shape.insts = value;
+    } else if (name == "branches" && value <= 100) {
+        shape.branches = value;
+    } else if (name == "fanout") {
+        shape.fanout = value;
+    } else if (name == "seed") {
+        shape.seed = value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+ModuleShape& commandLineShape() {
+    static ModuleShape shape;
+    return shape;
+}
+
+}
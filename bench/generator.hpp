@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace YAOPT::Bench {
+
+struct ModuleShape {
+    size_t functions = 1000;
+    size_t blocks = 8;
+    size_t insts = 8;
+    // Percentage of blocks that end in a conditional branch to the next block and a random later one;
+    // the others jump straight to the next block.
+    unsigned branches = 100;
+    // Operands are drawn from the last `fanout` registers that dominate the use, so smaller values keep
+    // live ranges short and give each register more uses. Zero makes every operand the argument.
+    size_t fanout = 16;
+    uint64_t seed = 42;
+};
+
+// Deterministic for a given shape and valid SSA: every use is dominated by its definition.
+std::string generateModule(ModuleShape const& shape);
+
+// Sets a knob from `<name>=<value>`, where the name is a ModuleShape field. Returns false if it is not one.
+bool setKnob(ModuleShape& shape, std::string_view arg);
+
+// The shape given on the command line, for suites that honour knobs.
+ModuleShape& commandLineShape();
+
+}
@@ -0,0 +1,74 @@
+#include "bench.hpp"
+#include "generator.hpp"
+
+#include "../parser.hpp"
+
+#include <chrono>
+#include <string>
+
+namespace YAOPT::Bench {
+
+template<typename F>
+static void counted(std::string_view name, F&& body) {
+    size_t before = allocations();
+    auto start = std::chrono::steady_clock::now();
+    body();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report(name, seconds, allocations() - before, "allocs");
+}
+
+static Value operand(size_t i) {
+    return Value(i & 1 ? "%a" : "%b");
+}
+
+void irSuite() {
+    constexpr size_t N = 1 << 20;
+    {
+        std::vector<std::unique_ptr<BinaryOpInst>> insts;
+        insts.reserve(N);
+        counted("insts/make_unique x 1M", [&] {
+            for (size_t i = 0; i < N; ++i) {
+                insts.push_back(std::make_unique<BinaryOpInst>(Opcode::ADD, Type::I64, operand(i), operand(i + 1)));
+            }
+        });
+        counted("insts/make_unique teardown", [&] { insts.clear(); });
+    }
+    {
+        Arena arena;
+        counted("insts/Arena::make x 1M", [&] {
+            for (size_t i = 0; i < N; ++i) {
+                keep(arena.make<BinaryOpInst>(Opcode::ADD, Type::I64, operand(i), operand(i + 1)));
+            }
+        });
+        counted("insts/Arena teardown", [&] { arena.release(); });
+    }
+
+    std::string code = generateModule({.functions = 4000, .blocks = 8, .insts = 8});
+    Parser parser(Input{code});
+    parser.tokenize();
+    size_t insts = 0, bytes = 0;
+    counted("module/Parser::parse", [&] { parser.parse(); });
+    for (auto&& entity : parser.entities) {
+        if (auto define = dynamic_cast<FunctionDefine*>(entity.get())) {
+            bytes += define->arena.capacity();
+            for (auto bb : define->bbs) {
+                for (auto inst : bb->insts) ++insts, keep(inst);
+            }
+        }
+    }
+    counted("module/teardown", [&] { parser.entities.clear(); });
+    printf("module: %zu bytes, %zu instructions, %.1f arena bytes/instruction, %zu symbols\n",
+           code.length(), insts, double(bytes) / insts, symbolCount());
+
+    for (size_t blocks : {1000, 4000, 16000}) {
+        Parser wide(Input{generateModule({.functions = 1, .blocks = blocks, .insts = 8})});
+        wide.tokenize();
+        wide.parse();
+        auto& define = dynamic_cast<FunctionDefine&>(*wide.entities.back());
+        keep(define.cfg());
+        report("flow/liveness x " + std::to_string(blocks) + " blocks",
+               measure([&] { keep(Liveness(define)); }), blocks, "blocks");
+    }
+}
+
+}
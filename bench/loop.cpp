@@ -0,0 +1,121 @@
+#include "bench.hpp"
+
+#include "../interp.hpp"
+#include "../parser.hpp"
+#include "../pass.hpp"
+
+#include <string>
+
+namespace YAOPT::Bench {
+
+// Fills an n x n x n array through a triple loop nest that recomputes every row address in the innermost loop.
+static constexpr const char* KERNEL = R"(declare ptr @malloc(i64)
+declare void @free(ptr)
+
+define i64 @fill(i64 %n) {
+entry:
+    %nn = mul i64 %n, %n
+    %cells = mul i64 %nn, %n
+    %bytes = mul i64 %cells, 8
+    %buf = call ptr @malloc(i64 %bytes)
+    br label %i_head
+i_head:
+    %i = phi i64 [ 0, %entry ], [ %i2, %j_exit ]
+    %ic = icmp slt i64 %i, %n
+    br i1 %ic, label %j_head, label %exit
+j_head:
+    %j = phi i64 [ 0, %i_head ], [ %j2, %k_exit ]
+    %jc = icmp slt i64 %j, %n
+    br i1 %jc, label %k_head, label %j_exit
+k_head:
+    %k = phi i64 [ 0, %j_head ], [ %k2, %k_body ]
+    %kc = icmp slt i64 %k, %n
+    br i1 %kc, label %k_body, label %k_exit
+k_body:
+    %plane = mul i64 %i, %nn
+    %planep = getelementptr inbounds i64, ptr %buf, i64 %plane
+    %row = mul i64 %j, %n
+    %rowp = getelementptr inbounds i64, ptr %planep, i64 %row
+    %cell = getelementptr inbounds i64, ptr %rowp, i64 %k
+    %scale = sdiv i64 %n, 2
+    %v = add i64 %k, %scale
+    store i64 %v, ptr %cell
+    %k2 = add i64 %k, 1
+    br label %k_head
+k_exit:
+    %j2 = add i64 %j, 1
+    br label %j_head
+j_exit:
+    %i2 = add i64 %i, 1
+    br label %i_head
+exit:
+    %last = sub i64 %cells, 1
+    %lastp = getelementptr inbounds i64, ptr %buf, i64 %last
+    %r = load i64, ptr %lastp
+    call void @free(ptr %buf)
+    ret i64 %r
+}
+)";
+
+// One function of `nests` sibling loop nests, each `depth` loops deep.
+static std::string nestedFunction(size_t nests, size_t depth) {
+    std::string buf = "define void @f(i64 %n) {\nentry:\n    br label %N0_0\n";
+    for (size_t a = 0; a < nests; ++a) {
+        auto head = [&](size_t d) { return "N" + std::to_string(a) + "_" + std::to_string(d); };
+        auto next = a + 1 == nests ? std::string("exit") : "N" + std::to_string(a + 1) + "_0";
+        for (size_t d = 0; d < depth; ++d) {
+            auto reg = "%" + head(d);
+            auto out = d ? head(d - 1) + "_latch" : next;
+            buf += head(d) + ":\n";
+            buf += "    " + reg + "_c = icmp slt i64 %n, " + std::to_string(d) + "\n";
+            buf += "    br i1 " + reg + "_c, label %" + (d + 1 < depth ? head(d + 1) : head(d) + "_latch")
+                    + ", label %" + out + "\n";
+        }
+        for (size_t d = depth; d-- > 0;) {
+            buf += head(d) + "_latch:\n    br label %" + head(d) + "\n";
+        }
+    }
+    return buf + "exit:\n    ret void\n}\n";
+}
+
+static FunctionDefine* firstDefine(Parser& parser) {
+    for (auto&& entity : parser.entities) {
+        if (auto define = dynamic_cast<FunctionDefine*>(entity.get())) return define;
+    }
+    return nullptr;
+}
+
+// The loop nest analysis over many nests, and the triple loop kernel interpreted with and without licm.
+void loopSuite() {
+    Parser nested(Input{nestedFunction(1 << 12, 4)});
+    nested.tokenize();
+    nested.parse();
+    auto define = firstDefine(nested);
+    auto& cfg = define->cfg();
+    auto& tree = define->dominators();
+    size_t loops = 0;
+    double seconds = measure([&] {
+        LoopInfo info(cfg, tree);
+        loops = info.size();
+        keep(info);
+    });
+    report("loop/LoopInfo", seconds, loops, "loops");
+
+    std::string_view arg = "64";
+    for (auto pipeline : {"mem2reg,sccp,gvn,adce", "mem2reg,sccp,licm,gvn,adce"}) {
+        Parser parser(Input{KERNEL});
+        parser.tokenize();
+        parser.parse();
+        FunctionPassManager passes;
+        (void) parsePipeline(pipeline, passes);
+        std::vector<size_t> changes(passes.passes.size());
+        passes.run(*firstDefine(parser), changes);
+        Interpreter interpreter(parser.entities);
+        interpreter.bindStandard();
+        Interpreter::Result result;
+        seconds = measure([&] { result = interpreter.run("@fill", {&arg, 1}); });
+        report(join("loop/run ", pipeline), seconds, result.insts, "insts");
+    }
+}
+
+}
@@ -0,0 +1,55 @@
+#include "bench.hpp"
+#include "generator.hpp"
+
+#include <cstring>
+
+namespace YAOPT::Bench {
+
+void scanSuite();
+void irSuite();
+void domSuite();
+void pipelineSuite();
+void dispatchSuite();
+void loopSuite();
+
+constexpr Suite SUITES[] = {
+    {"scan", scanSuite},
+    {"ir", irSuite},
+    {"dom", domSuite},
+    {"pipeline", pipelineSuite},
+    {"dispatch", dispatchSuite},
+    {"loop", loopSuite},
+};
+
+}
+
+int main(int argc, const char* argv[]) {
+    using namespace YAOPT::Bench;
+    int suites = 0;
+    bool valid = true;
+    for (int i = 1; i < argc; ++i) {
+        if (!strchr(argv[i], '=')) {
+            ++suites;
+        } else {
+            valid &= setKnob(commandLineShape(), argv[i]);
+        }
+    }
+    bool found = valid && !suites;
+    for (auto&& suite : SUITES) {
+        bool selected = valid && !suites;
+        for (int i = 1; valid && i < argc; ++i) {
+            selected |= !strcmp(argv[i], suite.name);
+        }
+        if (selected) {
+            found = true;
+            printf("== %s\n", suite.name);
+            suite.run();
+        }
+    }
+    if (!found) {
+        fprintf(stderr, "usage: yaopt_bench [suite...] [<knob>=<value>...]\nsuites:");
+        for (auto&& suite : SUITES) fprintf(stderr, " %s", suite.name);
+        fprintf(stderr, "\nknobs: functions blocks insts branches fanout seed\n");
+        return 10;
+    }
+}
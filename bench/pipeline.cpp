@@ -0,0 +1,89 @@
+#include "bench.hpp"
+#include "generator.hpp"
+
+#include "../parser.hpp"
+#include "../pass.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace YAOPT::Bench {
+
+// Times every stage of a YAOPT run once over one generated module, single-threaded, in pipeline order.
+// Throughput is against the module's source bytes and parsed instruction count for every stage, so the
+// stages compare directly; peak RSS is restarted before each stage where the platform allows it.
+void pipelineSuite() {
+    auto& shape = commandLineShape();
+    std::string code = generateModule(shape);
+    size_t insts = shape.functions * (shape.blocks * (shape.insts + 2) + 1);
+    auto stage = [&](std::string_view name, auto&& body) {
+        size_t rss = resetPeakRSS();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report(name, seconds, code.length(), insts, rss, peakRSS());
+    };
+    printf("module: %zu functions x %zu blocks x %zu insts, branches=%u%%, fanout=%zu, %zu bytes\n",
+           shape.functions, shape.blocks, shape.insts, shape.branches, shape.fanout, code.length());
+
+    Parser parser(Input{code});
+    stage("Source::append", [&] { parser.tokenize(); });
+    stage("Parser::parse", [&] { parser.parse(); });
+    insts = 0;
+    for (auto&& entity : parser.entities) {
+        if (auto define = dynamic_cast<FunctionDefine*>(entity.get())) {
+            for (auto bb : define->bbs) {
+                for (auto inst : bb->insts) insts += inst->kind() != Inst::Kind::LABEL;
+            }
+        }
+    }
+    stage("CFG", [&] {
+        for (auto&& entity : parser.entities) {
+            if (auto define = dynamic_cast<FunctionDefine*>(entity.get())) keep(CFG(*define));
+        }
+    });
+    // Every registered pass once, in registry order; aliases are skipped.
+    FunctionPassManager passes;
+    for (auto&& pass : functionPasses()) {
+        bool alias = std::ranges::any_of(passes.passes, [&](FunctionPass const* seen) { return seen->run == pass.run; });
+        if (!alias) passes.passes.push_back(&pass);
+    }
+    for (auto pass : passes.passes) {
+        size_t changes = 0;
+        stage(join("pass/", pass->name), [&] {
+            for (auto&& entity : parser.entities) {
+                if (auto define = dynamic_cast<FunctionDefine*>(entity.get())) {
+                    auto result = pass->run(*define);
+                    define->invalidate(result.changed);
+                    changes += result.changes;
+                }
+            }
+        });
+        printf("%-48s %zu changes\n", "", changes);
+    }
+    StringSink sink;
+    stage("serialize", [&] {
+        for (auto&& entity : parser.entities) entity->serialize(sink);
+    });
+    printf("%-48s %zu bytes out\n", "", sink.size());
+
+    // The same passes and output again, one function at a time, after the whole-module IR is gone.
+    parser.entities.clear();
+    parser.source = {};
+    std::vector<size_t> changes(passes.passes.size());
+    size_t written = 0;
+    Parser streamer(Input{code});
+    stage("Parser::stream", [&] {
+        streamer.stream([&](Parser::Span span) {
+            auto entity = streamer.parseEntity(span);
+            if (auto define = dynamic_cast<FunctionDefine*>(entity.get())) passes.run(*define, changes);
+            StringSink part;
+            entity->serialize(part);
+            written += part.size();
+        });
+    });
+    printf("%-48s %zu bytes out\n", "", written);
+}
+
+}
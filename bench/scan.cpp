@@ -0,0 +1,105 @@
+#include "bench.hpp"
+#include "generator.hpp"
+
+#include "../scan.hpp"
+#include "../source.hpp"
+#include "../util.hpp"
+
+#include <cctype>
+#include <string>
+
+namespace YAOPT::Bench {
+
+static size_t legacyCountLines(std::string_view view) {
+    size_t lines = 1;
+    const char *q = view.begin();
+    while (q != view.end()) {
+        if (*q == '\n' || *q == '\r') {
+            ++lines;
+            if (q[0] == '\r' && q + 1 != view.end() && q[1] == '\n') ++q;
+        }
+        ++q;
+    }
+    return lines;
+}
+
+static size_t countLines(Scanner const& scan, std::string_view view) {
+    size_t lines = 1;
+    const char *q = view.begin();
+    while ((q = scan.findLineBreak(q, view.end())) != view.end()) {
+        ++lines;
+        if (q[0] == '\r' && q + 1 != view.end() && q[1] == '\n') ++q;
+        ++q;
+    }
+    return lines;
+}
+
+static size_t legacySkipIndent(std::vector<std::string_view> const& lines) {
+    size_t blanks = 0;
+    for (auto line : lines) {
+        const char* p = line.begin();
+        while (p != line.end() && (*p == ' ' || *p == '\t')) ++p;
+        blanks += p - line.begin();
+    }
+    return blanks;
+}
+
+static size_t skipIndent(Scanner const& scan, std::vector<std::string_view> const& lines) {
+    size_t blanks = 0;
+    for (auto line : lines) {
+        blanks += scan.skipBlanks(line.begin(), line.end()) - line.begin();
+    }
+    return blanks;
+}
+
+static size_t legacyCountClasses(std::string_view view) {
+    size_t count = 0;
+    for (char ch : view) {
+        count += isalpha(ch) || ch == '_' || ispunct(ch);
+    }
+    return count;
+}
+
+static size_t countClasses(std::string_view view) {
+    size_t count = 0;
+    for (char ch : view) {
+        count += is(ch, IDENTIFIER_START | PUNCTUATION);
+    }
+    return count;
+}
+
+void scanSuite() {
+    std::string code = generateModule({.functions = 4000, .blocks = 8, .insts = 8});
+    std::string wide;
+    for (char ch : code) {
+        wide += ch;
+        if (ch == '\n') wide += std::string(28, ' ');
+    }
+    report("lines/legacy", measure([&] { keep(legacyCountLines(code)); }), code.length());
+    for (auto scan : scanners()) {
+        report(std::string("lines/") + scan->name, measure([&] { keep(countLines(*scan, code)); }), code.length());
+    }
+    auto lines = splitLines(wide);
+    report("indent/legacy (32 columns)", measure([&] { keep(legacySkipIndent(lines)); }), wide.length());
+    for (auto scan : scanners()) {
+        report(std::string("indent/") + scan->name + " (32 columns)",
+               measure([&] { keep(skipIndent(*scan, lines)); }), wide.length());
+    }
+    report("classes/<cctype>", measure([&] { keep(legacyCountClasses(code)); }), code.length());
+    report("classes/CHAR_CLASS", measure([&] { keep(countClasses(code)); }), code.length());
+    report("tokenize/Source::append", measure([&] {
+        Source source;
+        source.append(code);
+        keep(source.tokens.size());
+    }, 1.0), code.length());
+    Source source;
+    source.append(code);
+    auto& tokens = source.tokens;
+    size_t count = tokens.columns.size();
+    size_t bytes = count * (sizeof(uint32_t) + sizeof(uint16_t) + sizeof(TokenType) + sizeof(Keyword))
+            + tokens.lines.size() * sizeof(uint32_t) + tokens.starts.size() * sizeof(uint32_t);
+    printf("tokens: %zu in %zu lines, %.2f bytes/token (%zu bytes/token as Token)\n",
+           count, tokens.size(), double(bytes) / count, sizeof(Token));
+}
+
+}
@@ -0,0 +1,96 @@
+#include "cache.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <system_error>
+
+namespace YAOPT {
+
+namespace {
+
+struct Hasher {
+    uint64_t low, high;
+
+    void update(std::string_view bytes) noexcept {
+        for (unsigned char c : bytes) {
+            low = (low ^ c) * 0x100000001b3;
+            high = (high ^ c) * 0x9e3779b97f4a7c15;
+        }
+    }
+    void separate(char c) noexcept {
+        update({&c, 1});
+    }
+};
+
+[[nodiscard]] uint64_t mix(uint64_t x) noexcept {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccd;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53;
+    return x ^ x >> 33;
+}
+
+}
+
+ResultCache::ResultCache(std::string directory, std::string_view config): directory(std::move(directory)) {
+    Hasher hasher{0xcbf29ce484222325, 0x84222325cbf29ce4};
+    hasher.update(YAOPT_VERSION);
+    hasher.separate('\0');
+    hasher.update(config);
+    seed = {hasher.low, hasher.high};
+    std::error_code ec;
+    std::filesystem::create_directories(this->directory, ec);
+}
+
+ResultCache::Key ResultCache::key(Source const& source, size_t begin, size_t end) const noexcept {
+    Hasher hasher{seed.low, seed.high};
+    for (size_t i = begin; i != end; ++i) {
+        auto line = source.tokens[i];
+        for (size_t j = 0; j < line.size(); ++j) {
+            hasher.update(source.of(line[j]));
+            hasher.separate('\x1f');
+        }
+        hasher.separate('\n');
+    }
+    return {mix(hasher.low), mix(hasher.high ^ hasher.low)};
+}
+
+std::string ResultCache::path(Key key) const {
+    char name[33];
+    snprintf(name, sizeof name, "%016llx%016llx", (unsigned long long) key.high, (unsigned long long) key.low);
+    return join(directory, "/", name);
+}
+
+std::optional<std::string> ResultCache::load(Key key) {
+    FILE* file = fopen(path(key).c_str(), "rb");
+    if (!file) {
+        ++misses;
+        return std::nullopt;
+    }
+    std::string text;
+    char buf[4096];
+    for (size_t n; (n = fread(buf, 1, sizeof buf, file)) != 0;) text.append(buf, n);
+    bool failed = ferror(file);
+    fclose(file);
+    if (failed) {
+        ++misses;
+        return std::nullopt;
+    }
+    ++hits;
+    return text;
+}
+
+void ResultCache::store(Key key, std::string_view text) const {
+    auto target = path(key);
+    auto temporary = join(target, ".", std::to_string(std::random_device()()), ".tmp");
+    FILE* file = fopen(temporary.c_str(), "wb");
+    if (!file) return;
+    bool written = fwrite(text.data(), 1, text.size(), file) == text.size();
+    written &= fclose(file) == 0;
+    std::error_code ec;
+    if (written) std::filesystem::rename(temporary, target, ec);
+    if (!written || ec) std::filesystem::remove(temporary, ec);
+}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "entity.hpp"
+#include "source.hpp"
+
+namespace YAOPT {
+
+// An entity restored from the result cache: its serialized text, with nothing left to parse or optimize.
+struct CachedEntity : Entity {
+    std::string text;
+
+    explicit CachedEntity(std::string text): text(std::move(text)) {}
+
+    void serialize(Sink& out) const override {
+        out.put(text);
+    }
+};
+
+// On-disk cache of serialized function results. A key hashes the token stream of one definition, which
+// ignores layout and comments, together with everything else the result depends on: the tool version,
+// the pass pipeline and the output options. Entries are written to a temporary file and renamed into
+// place, so concurrent runs sharing a directory never see a partial entry.
+struct ResultCache {
+    struct Key {
+        uint64_t low, high;
+    };
+
+    std::string directory;
+    std::atomic<size_t> hits = 0, misses = 0;
+
+    ResultCache(std::string directory, std::string_view config);
+
+    [[nodiscard]] Key key(Source const& source, size_t begin, size_t end) const noexcept;
+    [[nodiscard]] std::optional<std::string> load(Key key);
+    void store(Key key, std::string_view text) const;
+
+private:
+    Key seed;
+
+    [[nodiscard]] std::string path(Key key) const;
+};
+
+}
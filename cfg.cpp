@@ -0,0 +1,68 @@
+#include "cfg.hpp"
+#include "entity.hpp"
+
+#include <algorithm>
+
+namespace YAOPT {
+
+namespace {
+
+std::vector<CFG::Edge> edgesOf(FunctionDefine const& define) {
+    std::vector<CFG::Edge> edges;
+    edges.reserve(define.bbs.size() * 2);
+    for (auto bb : define.bbs) {
+        bb->terminatorInst->forEachTarget([&](Symbol&, BasicBlock*& target) {
+            edges.emplace_back(bb->index, target->index);
+        });
+    }
+    return edges;
+}
+
+}
+
+CFG::CFG(FunctionDefine const& define):
+        CFG(define.bbs.size(), edgesOf(define)) {}
+
+CFG::CFG(uint32_t size, std::span<const Edge> edges, uint32_t entry): entry(entry),
+        succBegin(size + 1), succs(edges.size()), predBegin(size + 1), preds(edges.size()), order(size, NONE) {
+    for (auto [from, to] : edges) {
+        ++succBegin[from + 1];
+        ++predBegin[to + 1];
+    }
+    for (uint32_t i = 0; i < size; ++i) {
+        succBegin[i + 1] += succBegin[i];
+        predBegin[i + 1] += predBegin[i];
+    }
+    std::vector<uint32_t> succNext(succBegin.begin(), succBegin.end() - 1);
+    std::vector<uint32_t> predNext(predBegin.begin(), predBegin.end() - 1);
+    for (auto [from, to] : edges) {
+        succs[succNext[from]++] = to;
+        preds[predNext[to]++] = from;
+    }
+    if (size == 0) return;
+
+    // Iterative DFS; each frame remembers the next successor to visit.
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    rpo.reserve(size);
+    order[entry] = 0;
+    stack.emplace_back(entry, succBegin[entry]);
+    while (!stack.empty()) {
+        auto& [block, next] = stack.back();
+        if (next != succBegin[block + 1]) {
+            uint32_t succ = succs[next++];
+            if (order[succ] == NONE) {
+                order[succ] = 0;
+                stack.emplace_back(succ, succBegin[succ]);
+            }
+        } else {
+            rpo.push_back(block);
+            stack.pop_back();
+        }
+    }
+    std::ranges::reverse(rpo);
+    for (uint32_t i = 0; i < rpo.size(); ++i) {
+        order[rpo[i]] = i;
+    }
+}
+
+}
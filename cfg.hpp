@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace YAOPT {
+
+struct FunctionDefine;
+
+struct CFG {
+    static constexpr uint32_t NONE = UINT32_MAX;
+    using Edge = std::pair<uint32_t, uint32_t>;
+
+    uint32_t entry = 0;
+    std::vector<uint32_t> succBegin, succs;
+    std::vector<uint32_t> predBegin, preds;
+    std::vector<uint32_t> rpo;
+    std::vector<uint32_t> order;
+
+    explicit CFG(FunctionDefine const& define);
+    CFG(uint32_t size, std::span<const Edge> edges, uint32_t entry = 0);
+
+    [[nodiscard]] uint32_t size() const noexcept {
+        return succBegin.size() - 1;
+    }
+    [[nodiscard]] std::span<const uint32_t> successors(uint32_t block) const noexcept {
+        return {succs.data() + succBegin[block], succs.data() + succBegin[block + 1]};
+    }
+    [[nodiscard]] std::span<const uint32_t> predecessors(uint32_t block) const noexcept {
+        return {preds.data() + predBegin[block], preds.data() + predBegin[block + 1]};
+    }
+    [[nodiscard]] bool reachable(uint32_t block) const noexcept {
+        return order[block] != NONE;
+    }
+    [[nodiscard]] auto postorder() const noexcept {
+        return std::views::reverse(rpo);
+    }
+    [[nodiscard]] uint32_t postorderNumber(uint32_t block) const noexcept {
+        return rpo.size() - 1 - order[block];
+    }
+};
+
+}
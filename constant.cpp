@@ -0,0 +1,114 @@
+#include "constant.hpp"
+
+#include <charconv>
+#include <cmath>
+
+namespace YAOPT {
+
+std::string Constant::text() const {
+    switch (type) {
+        case Type::I1:
+            return bits ? "true" : "false";
+        case Type::I64:
+            return std::to_string(int64_t(bits));
+        case Type::PTR:
+            return bits ? std::string() : "null";
+        case Type::DOUBLE: {
+            double value = asDouble();
+            if (!std::isfinite(value)) return {};
+            char buf[32];
+            auto end = std::to_chars(buf, buf + sizeof buf, value).ptr;
+            std::string text(buf, end);
+            if (text.find_first_of(".e") == std::string::npos) text += ".0";
+            return text;
+        }
+        default:
+            return {};
+    }
+}
+
+std::optional<Constant> parseConstant(Type type, std::string_view literal) noexcept {
+    if (type == Type::I1) {
+        if (literal == "true") return Constant::ofBool(true);
+        if (literal == "false") return Constant::ofBool(false);
+    }
+    if (type == Type::PTR) {
+        if (literal == "null") return Constant{Type::PTR, 0};
+        return std::nullopt;
+    }
+    if (literal.empty() || literal.find_first_not_of("-+.0123456789_eE") != std::string_view::npos) {
+        return std::nullopt;
+    }
+    char buf[64];
+    if (literal.find('_') != std::string_view::npos) {
+        if (literal.length() > sizeof buf) return std::nullopt;
+        size_t length = 0;
+        for (char ch : literal) {
+            if (ch != '_') buf[length++] = ch;
+        }
+        literal = {buf, length};
+    }
+    const char *begin = literal.data(), *end = begin + literal.length();
+    if (type == Type::DOUBLE) {
+        double value;
+        if (auto [ptr, ec] = std::from_chars(begin, end, value); ec != std::errc{} || ptr != end) return std::nullopt;
+        return Constant::ofDouble(value);
+    }
+    if (type != Type::I1 && type != Type::I64) return std::nullopt;
+    int64_t value;
+    if (auto [ptr, ec] = std::from_chars(begin, end, value); ec == std::errc{} && ptr == end) {
+        if (type == Type::I1 && value != 0 && value != 1 && value != -1) return std::nullopt;
+        return Constant::ofInt(type, value);
+    }
+    uint64_t unsignedValue;
+    if (auto [ptr, ec] = std::from_chars(begin, end, unsignedValue); ec == std::errc{} && ptr == end) {
+        if (type == Type::I1) return std::nullopt;
+        return Constant::ofInt(type, unsignedValue);
+    }
+    return std::nullopt;
+}
+
+std::optional<ConstantPool::Entry> ConstantTraits::make(Key key, Arena& arena) {
+    auto value = parseConstant(key.type, key.text);
+    if (!value) return std::nullopt;
+    return Entry{*value, copyText(key.text, arena)};
+}
+
+namespace {
+
+ShardedInterner<ConstantTraits>& constants() {
+    static ShardedInterner<ConstantTraits> constants;
+    return constants;
+}
+
+}
+
+uint32_t ConstantPool::intern(Type type, std::string_view literal) {
+    return constants().intern({type, literal});
+}
+
+uint32_t ConstantPool::intern(Constant value) {
+    auto text = value.text();
+    return text.empty() ? NONE : intern(value.type, text);
+}
+
+ConstantPool::Entry const& ConstantPool::at(uint32_t id) noexcept {
+    if (id & LOCAL) return ScopedInterner<ConstantTraits>::at(id & ~LOCAL);
+    return constants().at(id);
+}
+
+size_t ConstantPool::size() noexcept {
+    return constants().size();
+}
+
+uint32_t ConstantScope::intern(Type type, std::string_view literal) {
+    uint32_t slot = constants.intern({type, literal});
+    return slot == ConstantPool::NONE ? ConstantPool::NONE : slot | ConstantPool::LOCAL;
+}
+
+uint32_t ConstantScope::intern(Constant value) {
+    auto text = value.text();
+    return text.empty() ? ConstantPool::NONE : intern(value.type, text);
+}
+
+}
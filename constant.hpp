@@ -0,0 +1,99 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "intern.hpp"
+#include "type.hpp"
+
+namespace YAOPT {
+
+// A scalar of an IR type: integers are kept zero-extended in two's complement, doubles by their bit pattern.
+struct Constant {
+    Type type = Type::VOID;
+    uint64_t bits = 0;
+
+    [[nodiscard]] static Constant ofInt(Type type, uint64_t value) noexcept {
+        return {type, type == Type::I1 ? value & 1 : value};
+    }
+    [[nodiscard]] static Constant ofBool(bool value) noexcept {
+        return {Type::I1, value};
+    }
+    [[nodiscard]] static Constant ofDouble(double value) noexcept {
+        return {Type::DOUBLE, std::bit_cast<uint64_t>(value)};
+    }
+
+    [[nodiscard]] int64_t asSigned() const noexcept {
+        return type == Type::I1 ? -int64_t(bits) : int64_t(bits);
+    }
+    [[nodiscard]] double asDouble() const noexcept {
+        return std::bit_cast<double>(bits);
+    }
+    [[nodiscard]] bool operator==(Constant const&) const noexcept = default;
+
+    // Literal text the lexer reads back to the same value; empty when there is none (NaN, infinities).
+    [[nodiscard]] std::string text() const;
+};
+
+// Reads a literal of `type` with std::from_chars, skipping `_` separators, without allocating. Returns
+// std::nullopt when the literal is not of that type or does not fit in it.
+[[nodiscard]] std::optional<Constant> parseConstant(Type type, std::string_view literal) noexcept;
+
+// Literal constants, deduplicated by type and spelling, so each one is parsed once. An entry keeps the
+// spelling next to the value and prints it back exactly as it was read; constants made by folding are spelled
+// by Constant::text(). The pool itself holds constants for the whole process; the constants of a function go
+// into its ConstantScope and are freed with it, under ids that carry the LOCAL bit. Lookups by id take no
+// lock and need no scope.
+struct ConstantPool {
+    static constexpr uint32_t NONE = UINT32_MAX, LOCAL = 1u << 31;
+
+    struct Entry {
+        Constant value;
+        std::string_view text;
+    };
+
+    // The entry of `literal` read as `type`, or NONE when it is not a constant of that type.
+    [[nodiscard]] static uint32_t intern(Type type, std::string_view literal);
+    // The entry of `value` spelled by Constant::text(), or NONE when the value has no spelling.
+    [[nodiscard]] static uint32_t intern(Constant value);
+    [[nodiscard]] static Entry const& at(uint32_t id) noexcept;
+    [[nodiscard]] static size_t size() noexcept;
+};
+
+struct ConstantTraits {
+    struct Key {
+        Type type;
+        std::string_view text;
+
+        [[nodiscard]] bool operator==(Key const&) const noexcept = default;
+    };
+    struct Hash {
+        size_t operator()(Key key) const noexcept {
+            return std::hash<std::string_view>{}(key.text) * 31 + size_t(key.type);
+        }
+    };
+    using Entry = ConstantPool::Entry;
+
+    static constexpr const char* WHAT = "too many constants";
+
+    static std::optional<Entry> make(Key key, Arena& arena);
+    static Key key(Entry const& entry) noexcept {
+        return {entry.value.type, entry.text};
+    }
+};
+
+// The constants of one function, interned like ConstantPool::intern() does.
+struct ConstantScope {
+    explicit ConstantScope(Arena& text): constants(text) {}
+
+    [[nodiscard]] uint32_t intern(Type type, std::string_view literal);
+    [[nodiscard]] uint32_t intern(Constant value);
+
+private:
+    ScopedInterner<ConstantTraits> constants;
+};
+
+}
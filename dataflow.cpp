@@ -0,0 +1,89 @@
+#include "dataflow.hpp"
+#include "entity.hpp"
+
+#include <unordered_map>
+
+namespace YAOPT {
+
+// Only values used outside their defining block can be live across an edge, so they alone get a bit.
+Liveness::Liveness(FunctionDefine const& define): flow(0, 0) {
+    auto& ssa = define.ssa;
+    auto& cfg = define.cfg();
+    std::vector<uint32_t> home(ssa.size(), CFG::NONE);
+    for (auto bb : define.bbs) {
+        for (auto inst : bb->insts) {
+            if (inst->kind() != Inst::Kind::INTERMEDIATE) continue;
+            auto number = static_cast<IntermediateInst*>(inst)->number;
+            if (number != Value::NONE) home[number] = bb->index;
+        }
+    }
+    facts.assign(ssa.size(), CFG::NONE);
+    bool phis = false;
+    for (auto bb : define.bbs) {
+        for (auto inst : bb->insts) {
+            bool phi = dyn_cast<PhiInst>(inst);
+            phis |= phi;
+            inst->forEachOperand([&](Value& value) {
+                if (value.reg == Value::NONE) return;
+                uint32_t reg = ssa.root(value.reg);
+                if ((phi || home[reg] != bb->index) && facts[reg] == CFG::NONE) {
+                    facts[reg] = regs.size();
+                    regs.push_back(reg);
+                }
+            });
+        }
+    }
+    flow = Dataflow<Direction::BACKWARD>(cfg.size(), regs.size());
+    if (phis) flow.seed = BitMatrix(cfg.size(), regs.size());
+    for (auto bb : define.bbs) {
+        for (auto inst : bb->insts) {
+            // A phi reads its operand at the end of the incoming block, not in its own block.
+            if (auto phi = dyn_cast<PhiInst>(inst)) {
+                for (auto&& in : phi->incoming) {
+                    if (in.value.reg != Value::NONE) flow.seed.set(in.block->index, facts[ssa.root(in.value.reg)]);
+                }
+                if (phi->number != Value::NONE && facts[phi->number] != CFG::NONE) flow.kill.set(bb->index, facts[phi->number]);
+                continue;
+            }
+            inst->forEachOperand([&](Value& value) {
+                if (value.reg == Value::NONE) return;
+                uint32_t fact = facts[ssa.root(value.reg)];
+                if (fact != CFG::NONE && !flow.kill.test(bb->index, fact)) flow.gen.set(bb->index, fact);
+            });
+            if (inst->kind() != Inst::Kind::INTERMEDIATE) continue;
+            auto number = static_cast<IntermediateInst*>(inst)->number;
+            if (number != Value::NONE && facts[number] != CFG::NONE) flow.kill.set(bb->index, facts[number]);
+        }
+    }
+    flow.solve(cfg);
+}
+
+// Stores through the same pointer value overwrite each other; anything else may alias and kills nothing.
+ReachingStores::ReachingStores(FunctionDefine const& define): flow(0, 0) {
+    auto& ssa = define.ssa;
+    auto address = [&](StoreInst const* store) {
+        auto& into = store->into;
+        return into.reg == Value::NONE ? into.immediateKey() : ssa.root(into.reg);
+    };
+    std::unordered_map<uint64_t, std::vector<uint32_t>> byAddress;
+    for (auto bb : define.bbs) {
+        for (auto inst : bb->insts) {
+            if (auto store = dyn_cast<StoreInst>(inst)) {
+                byAddress[address(store)].push_back(stores.size());
+                stores.push_back(store);
+                blocks.push_back(bb->index);
+            }
+        }
+    }
+    flow = Dataflow<Direction::FORWARD>(define.bbs.size(), stores.size());
+    for (uint32_t i = 0; i < stores.size(); ++i) {
+        for (auto other : byAddress[address(stores[i])]) {
+            flow.gen.reset(blocks[i], other);
+            flow.kill.set(blocks[i], other);
+        }
+        flow.gen.set(blocks[i], i);
+    }
+    flow.solve(define.cfg());
+}
+
+}
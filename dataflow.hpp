@@ -0,0 +1,155 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "cfg.hpp"
+
+namespace YAOPT {
+
+struct FunctionDefine;
+struct StoreInst;
+
+struct BitMatrix {
+    size_t words = 0;
+    std::vector<uint64_t> bits;
+
+    BitMatrix() = default;
+    BitMatrix(size_t rows, size_t columns, bool value = false):
+            words((columns + 63) / 64), bits(rows * words, value ? ~uint64_t() : 0) {}
+
+    [[nodiscard]] std::span<uint64_t> operator[](size_t row) noexcept {
+        return {bits.data() + row * words, words};
+    }
+    [[nodiscard]] std::span<const uint64_t> operator[](size_t row) const noexcept {
+        return {bits.data() + row * words, words};
+    }
+    [[nodiscard]] bool test(size_t row, size_t column) const noexcept {
+        return bits[row * words + column / 64] >> column % 64 & 1;
+    }
+    void set(size_t row, size_t column) noexcept {
+        bits[row * words + column / 64] |= uint64_t(1) << column % 64;
+    }
+    void reset(size_t row, size_t column) noexcept {
+        bits[row * words + column / 64] &= ~(uint64_t(1) << column % 64);
+    }
+
+    template<typename F>
+    void forEach(size_t row, F&& f) const {
+        auto line = (*this)[row];
+        for (size_t i = 0; i < words; ++i) {
+            for (uint64_t word = line[i]; word; word &= word - 1) {
+                f(i * 64 + std::countr_zero(word));
+            }
+        }
+    }
+};
+
+enum class Direction {
+    FORWARD, BACKWARD
+};
+
+enum class Meet {
+    UNION, INTERSECTION
+};
+
+// Gen/kill problem over the CFG: out = gen | (in & ~kill), read against the flow direction for BACKWARD.
+// `in` is always the side the meet is taken on, so for BACKWARD it holds the values at block exits.
+// When `seed` has rows, they are added to `in` after the meet (entry facts, phi operands on their edge).
+template<Direction direction, Meet meet = Meet::UNION>
+struct Dataflow {
+    BitMatrix gen, kill, in, out, seed;
+
+    Dataflow(uint32_t blocks, size_t facts):
+            gen(blocks, facts), kill(blocks, facts), in(blocks, facts), out(blocks, facts, meet == Meet::INTERSECTION) {}
+
+    void solve(CFG const& cfg) {
+        uint32_t size = cfg.size();
+        size_t words = gen.words;
+        std::vector<uint32_t> order;
+        order.reserve(size);
+        if constexpr (direction == Direction::FORWARD) {
+            order.assign(cfg.rpo.begin(), cfg.rpo.end());
+        } else {
+            order.assign(cfg.rpo.rbegin(), cfg.rpo.rend());
+        }
+        for (uint32_t block = 0; block < size; ++block) {
+            if (!cfg.reachable(block)) order.push_back(block);
+        }
+        std::vector<bool> pending(size, true);
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (auto block : order) {
+                if (!pending[block]) continue;
+                pending[block] = false;
+                auto sources = direction == Direction::FORWARD ? cfg.predecessors(block) : cfg.successors(block);
+                auto merged = in[block];
+                for (size_t i = 0; i < words; ++i) {
+                    merged[i] = meet == Meet::INTERSECTION && !sources.empty() ? ~uint64_t() : 0;
+                }
+                for (auto source : sources) {
+                    auto from = out[source];
+                    for (size_t i = 0; i < words; ++i) {
+                        merged[i] = meet == Meet::UNION ? merged[i] | from[i] : merged[i] & from[i];
+                    }
+                }
+                if (seed.words) {
+                    auto extra = seed[block];
+                    for (size_t i = 0; i < words; ++i) merged[i] |= extra[i];
+                }
+                auto result = out[block], g = gen[block], k = kill[block];
+                uint64_t diff = 0;
+                for (size_t i = 0; i < words; ++i) {
+                    uint64_t word = g[i] | (merged[i] & ~k[i]);
+                    diff |= word ^ result[i];
+                    result[i] = word;
+                }
+                if (!diff) continue;
+                changed = true;
+                for (auto next : direction == Direction::FORWARD ? cfg.successors(block) : cfg.predecessors(block)) {
+                    pending[next] = true;
+                }
+            }
+        }
+    }
+};
+
+struct Liveness {
+    std::vector<uint32_t> facts;
+    std::vector<uint32_t> regs;
+    Dataflow<Direction::BACKWARD> flow;
+
+    explicit Liveness(FunctionDefine const& define);
+
+    [[nodiscard]] bool liveIn(uint32_t block, uint32_t reg) const noexcept {
+        return facts[reg] != CFG::NONE && flow.out.test(block, facts[reg]);
+    }
+    [[nodiscard]] bool liveOut(uint32_t block, uint32_t reg) const noexcept {
+        return facts[reg] != CFG::NONE && flow.in.test(block, facts[reg]);
+    }
+    template<typename F>
+    void forEachLiveIn(uint32_t block, F&& f) const {
+        flow.out.forEach(block, [&](size_t fact) { f(regs[fact]); });
+    }
+    template<typename F>
+    void forEachLiveOut(uint32_t block, F&& f) const {
+        flow.in.forEach(block, [&](size_t fact) { f(regs[fact]); });
+    }
+};
+
+struct ReachingStores {
+    std::vector<StoreInst*> stores;
+    std::vector<uint32_t> blocks;
+    Dataflow<Direction::FORWARD> flow;
+
+    explicit ReachingStores(FunctionDefine const& define);
+
+    template<typename F>
+    void forEachReachingIn(uint32_t block, F&& f) const {
+        flow.in.forEach(block, [&](size_t fact) { f(stores[fact]); });
+    }
+};
+
+}
@@ -15,14 +15,14 @@ size_t getUnicodeWidth(std::string_view view, size_t line, size_t column) {
 
 std::string ErrorMessage::build(Source* source) {
     if (message.ends_with(' ')) message.pop_back();
-    if (textOnly || source == nullptr) return message + '\n';
+    if (textOnly || source == nullptr || !source->has(segment.line1) || !source->has(segment.line2)) return message + '\n';
     std::string result;
     result += message;
     result += "\n";
     int digits = digits10(segment.line2 + 1);
     for (size_t line = segment.line1; line <= segment.line2; ++line) {
         auto lineNo = std::to_string(line + 1);
-        auto code = source->lines.at(line);
+        auto code = source->expand(line);
         result += "   ";
         result += lineNo;
         result += std::string(digits - lineNo.length() + 1, ' ');
@@ -32,8 +32,8 @@ std::string ErrorMessage::build(Source* source) {
         result += std::string(digits + 1, ' ');
         result += " | ";
         if (size_t head = code.find_first_not_of(' '); head != std::string::npos) {
-            size_t column1 = line == segment.line1 ? segment.column1 : head;
-            size_t column2 = line == segment.line2 ? segment.column2 : code.length();
+            size_t column1 = line == segment.line1 ? source->display(line, segment.column1) : head;
+            size_t column2 = line == segment.line2 ? source->display(line, segment.column2) : code.length();
             size_t width1 = getUnicodeWidth(code.substr(0, column1), line, 0);
             result += std::string(width1, ' ');
             size_t width2 = getUnicodeWidth(code.substr(column1, column2 - column1), line, column1);
@@ -0,0 +1,165 @@
+#include "dom.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace YAOPT {
+
+DomTree::DomTree(CFG const& cfg, Algorithm algorithm): root(cfg.entry), idom(cfg.size(), CFG::NONE) {
+    if (cfg.size() == 0) {
+        childBegin.assign(1, 0);
+        return;
+    }
+    if (algorithm == Algorithm::AUTO) {
+        algorithm = cfg.size() < SEMI_NCA_THRESHOLD ? Algorithm::ITERATIVE : Algorithm::SEMI_NCA;
+    }
+    if (algorithm == Algorithm::ITERATIVE) {
+        iterative(cfg);
+    } else {
+        semiNCA(cfg);
+    }
+    number();
+}
+
+// Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm".
+void DomTree::iterative(CFG const& cfg) {
+    auto intersect = [&](uint32_t a, uint32_t b) {
+        while (a != b) {
+            while (cfg.order[a] > cfg.order[b]) a = idom[a];
+            while (cfg.order[b] > cfg.order[a]) b = idom[b];
+        }
+        return a;
+    };
+    idom[root] = root;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (uint32_t i = 1; i < cfg.rpo.size(); ++i) {
+            uint32_t block = cfg.rpo[i];
+            uint32_t dominator = CFG::NONE;
+            for (auto pred : cfg.predecessors(block)) {
+                if (idom[pred] == CFG::NONE) continue;
+                dominator = dominator == CFG::NONE ? pred : intersect(pred, dominator);
+            }
+            if (idom[block] != dominator) {
+                idom[block] = dominator;
+                changed = true;
+            }
+        }
+    }
+}
+
+// Semi-dominators as in Lengauer-Tarjan, then immediate dominators as nearest common ancestors
+// (Georgiadis, "Linear-Time Algorithms for Dominators and Related Problems").
+void DomTree::semiNCA(CFG const& cfg) {
+    std::vector<uint32_t> num(cfg.size(), CFG::NONE), vertex, parent;
+    vertex.reserve(cfg.rpo.size());
+    parent.reserve(cfg.rpo.size());
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    num[root] = 0;
+    vertex.push_back(root);
+    parent.push_back(0);
+    stack.emplace_back(root, cfg.succBegin[root]);
+    while (!stack.empty()) {
+        auto& [block, next] = stack.back();
+        if (next == cfg.succBegin[block + 1]) {
+            stack.pop_back();
+            continue;
+        }
+        uint32_t succ = cfg.succs[next++];
+        if (num[succ] != CFG::NONE) continue;
+        num[succ] = vertex.size();
+        parent.push_back(num[block]);
+        vertex.push_back(succ);
+        stack.emplace_back(succ, cfg.succBegin[succ]);
+    }
+
+    uint32_t size = vertex.size();
+    std::vector<uint32_t> semi(size), label(size), ancestor(size, CFG::NONE), path;
+    for (uint32_t i = 0; i < size; ++i) semi[i] = label[i] = i;
+    auto eval = [&](uint32_t v) {
+        if (ancestor[v] == CFG::NONE) return v;
+        path.clear();
+        for (uint32_t x = v; ancestor[ancestor[x]] != CFG::NONE; x = ancestor[x]) path.push_back(x);
+        for (auto x = path.rbegin(); x != path.rend(); ++x) {
+            uint32_t a = ancestor[*x];
+            if (semi[label[a]] < semi[label[*x]]) label[*x] = label[a];
+            ancestor[*x] = ancestor[a];
+        }
+        return label[v];
+    };
+    for (uint32_t w = size - 1; w > 0; --w) {
+        for (auto pred : cfg.predecessors(vertex[w])) {
+            if (num[pred] == CFG::NONE) continue;
+            semi[w] = std::min(semi[w], semi[eval(num[pred])]);
+        }
+        ancestor[w] = parent[w];
+    }
+
+    auto& dominator = parent;
+    for (uint32_t w = 1; w < size; ++w) {
+        uint32_t j = dominator[w];
+        while (j > semi[w]) j = dominator[j];
+        dominator[w] = j;
+    }
+    for (uint32_t w = 0; w < size; ++w) {
+        idom[vertex[w]] = vertex[dominator[w]];
+    }
+}
+
+void DomTree::number() {
+    uint32_t size = idom.size();
+    childBegin.assign(size + 1, 0);
+    for (uint32_t block = 0; block < size; ++block) {
+        if (block != root && reachable(block)) ++childBegin[idom[block] + 1];
+    }
+    for (uint32_t i = 0; i < size; ++i) childBegin[i + 1] += childBegin[i];
+    childBlocks.resize(childBegin[size]);
+    std::vector<uint32_t> next(childBegin.begin(), childBegin.end() - 1);
+    for (uint32_t block = 0; block < size; ++block) {
+        if (block != root && reachable(block)) childBlocks[next[idom[block]]++] = block;
+    }
+
+    in.assign(size, CFG::NONE);
+    out.assign(size, CFG::NONE);
+    uint32_t clock = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    in[root] = clock++;
+    stack.emplace_back(root, childBegin[root]);
+    while (!stack.empty()) {
+        auto& [block, next] = stack.back();
+        if (next == childBegin[block + 1]) {
+            out[block] = clock++;
+            stack.pop_back();
+            continue;
+        }
+        uint32_t child = childBlocks[next++];
+        in[child] = clock++;
+        stack.emplace_back(child, childBegin[child]);
+    }
+}
+
+DomFrontier::DomFrontier(CFG const& cfg, DomTree const& tree): begin(cfg.size() + 1, 0) {
+    uint32_t size = cfg.size();
+    auto up = [&](uint32_t block) {
+        return block == tree.root ? CFG::NONE : tree.idom[block];
+    };
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    std::vector<uint32_t> mark(size, CFG::NONE);
+    for (uint32_t block = 0; block < size; ++block) {
+        if (!tree.reachable(block)) continue;
+        for (auto pred : cfg.predecessors(block)) {
+            if (!tree.reachable(pred)) continue;
+            for (uint32_t runner = pred; runner != up(block) && mark[runner] != block; runner = up(runner)) {
+                mark[runner] = block;
+                pairs.emplace_back(runner, block);
+            }
+        }
+    }
+    for (auto [runner, block] : pairs) ++begin[runner + 1];
+    for (uint32_t i = 0; i < size; ++i) begin[i + 1] += begin[i];
+    blocks.resize(pairs.size());
+    std::vector<uint32_t> next(begin.begin(), begin.end() - 1);
+    for (auto [runner, block] : pairs) blocks[next[runner]++] = block;
+}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "cfg.hpp"
+
+namespace YAOPT {
+
+struct DomTree {
+    enum class Algorithm {
+        AUTO,
+        ITERATIVE,
+        SEMI_NCA,
+    };
+
+    // Around this size Semi-NCA starts to beat the Cooper-Harvey-Kennedy fixpoint (see `yaopt_bench dom`).
+    static constexpr uint32_t SEMI_NCA_THRESHOLD = 128;
+
+    uint32_t root = 0;
+    std::vector<uint32_t> idom;
+    std::vector<uint32_t> childBegin, childBlocks;
+    std::vector<uint32_t> in, out;
+
+    explicit DomTree(CFG const& cfg, Algorithm algorithm = Algorithm::AUTO);
+
+    [[nodiscard]] uint32_t size() const noexcept {
+        return idom.size();
+    }
+    [[nodiscard]] bool reachable(uint32_t block) const noexcept {
+        return idom[block] != CFG::NONE;
+    }
+    [[nodiscard]] std::span<const uint32_t> children(uint32_t block) const noexcept {
+        return {childBlocks.data() + childBegin[block], childBlocks.data() + childBegin[block + 1]};
+    }
+    // Every block dominates unreachable blocks, and unreachable blocks dominate nothing else.
+    [[nodiscard]] bool dominates(uint32_t a, uint32_t b) const noexcept {
+        if (a == b || !reachable(b)) return true;
+        if (!reachable(a)) return false;
+        return in[a] <= in[b] && out[b] <= out[a];
+    }
+    [[nodiscard]] bool strictlyDominates(uint32_t a, uint32_t b) const noexcept {
+        return a != b && dominates(a, b);
+    }
+
+private:
+    void iterative(CFG const& cfg);
+    void semiNCA(CFG const& cfg);
+    void number();
+};
+
+struct DomFrontier {
+    std::vector<uint32_t> begin, blocks;
+
+    DomFrontier(CFG const& cfg, DomTree const& tree);
+
+    [[nodiscard]] std::span<const uint32_t> of(uint32_t block) const noexcept {
+        return {blocks.data() + begin[block], blocks.data() + begin[block + 1]};
+    }
+};
+
+}
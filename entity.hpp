@@ -1,86 +1,131 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include "arena.hpp"
+#include "analysis.hpp"
 #include "inst.hpp"
+#include "ssa.hpp"
 
 
 namespace YAOPT {
 
 struct Entity : Descriptor {
-    std::string name;
+    Symbol name;
 
 };
 
 struct GlobalVariable : Entity {
-    [[nodiscard]] std::string serialize() const override {
-        std::string buf;
-        buf += "## ";
-        buf += name;
-        buf += '\n';
-        return buf;
+    // The scalar `@g = global <type> <constant>` form; any other initializer leaves `initializer` empty.
+    Type type = Type::VOID;
+    std::optional<Constant> initializer;
+
+    void serialize(Sink& out) const override {
+        out.print("## ", name.view(), "\n");
     }
 };
 
 struct FunctionDeclare : Entity {
-    [[nodiscard]] std::string serialize() const override {
-        std::string buf;
-        buf += "## ";
-        buf += name;
-        buf += '\n';
-        return buf;
+    void serialize(Sink& out) const override {
+        out.print("## ", name.view(), "\n");
     }
 };
 
-struct BasicBlock : Descriptor {
-    std::vector<std::unique_ptr<Inst>> insts;
-    LabelInst* labelInst;
-    TerminatorInst* terminatorInst;
-    explicit BasicBlock(std::vector<std::unique_ptr<Inst>> insts): insts(std::move(insts)) {
-        if (this->insts.size() < 2) {
-            throw std::invalid_argument("invalid basic block");
-        }
-        labelInst = dynamic_cast<LabelInst*>(this->insts.front().get());
-        terminatorInst = dynamic_cast<TerminatorInst*>(this->insts.back().get());
-        if (!labelInst || !terminatorInst) {
-            throw std::invalid_argument("invalid basic block");
-        }
-    }
+struct BasicBlock {
+    InstList insts;
+    LabelInst* labelInst = nullptr;
+    TerminatorInst* terminatorInst = nullptr;
+    uint32_t index = 0;
 
-    [[nodiscard]] std::string serialize() const override {
-        std::string buf;
-        buf += labelInst->label;
-        buf += "[\"";
-        for (auto&& inst : insts) {
-            buf += inst->serialize();
-            buf += "\\n";
-        }
-        buf += "\"]\n";
-        buf += terminatorInst->transition(labelInst->label);
-        buf += "\n";
-        return buf;
+    [[nodiscard]] std::string_view label() const noexcept {
+        return labelInst->label.view();
     }
 };
 
 struct FunctionDefine : Entity {
+    struct Param {
+        Type type;
+        Symbol name;
+    };
+
+    Arena arena;
+    // Register names, labels and literal constants; their text lives in `arena`.
+    SymbolScope symbols{arena};
+    ConstantScope constants{arena};
+    std::vector<Param> params;
+    std::vector<BasicBlock*> bbs;
+    SSA ssa;
+    // Adds the live registers to every block and, in a function that stores, the stores reaching it.
+    bool showLiveness = false;
 
-    std::vector<BasicBlock> bbs;
-
-    [[nodiscard]] std::string serialize() const override {
-        std::string buf;
-        buf += "## ";
-        buf += name;
-        buf += "\n";
-        buf += "```mermaid\n";
-        buf += "graph\n";
-        buf += "ENTER-->L0\n";
-        for (auto&& bb : bbs) {
-            buf += bb.serialize();
+    mutable AnalysisCache analyses;
+
+    [[nodiscard]] CFG const& cfg() const {
+        return analyses.cfg(*this);
+    }
+    [[nodiscard]] DomTree const& dominators() const {
+        return analyses.dominators(*this);
+    }
+    [[nodiscard]] LoopInfo const& loops() const {
+        return analyses.loops(*this);
+    }
+    [[nodiscard]] Liveness const& liveness() const {
+        return analyses.liveness(*this);
+    }
+    [[nodiscard]] ReachingStores const& reachingStores() const {
+        return analyses.reachingStores(*this);
+    }
+    void invalidate(Changed changed = Changed::CONTROL) noexcept {
+        analyses.invalidate(changed);
+    }
+
+    void serialize(Sink& out) const override {
+        auto& graph = cfg();
+        bool stores = showLiveness && !reachingStores().stores.empty();
+        out.print("## ", name.view(), "\n");
+        out.put("```mermaid\n");
+        out.put("graph\n");
+        if (!bbs.empty()) {
+            out.print("ENTER-->", bbs[graph.entry]->label(), "\n");
+        }
+        for (auto bb : bbs) {
+            out.print(bb->label(), "[\"");
+            for (auto inst : bb->insts) {
+                inst->serialize(out);
+                out.put("\\n");
+                if (showLiveness && inst == bb->labelInst) {
+                    out.put("live-in:");
+                    liveness().forEachLiveIn(bb->index, [&](uint32_t reg) { out.print(" ", ssa.slots[reg].name.view()); });
+                    out.put("\\n");
+                    if (stores) {
+                        out.put("stores-in:");
+                        reachingStores().forEachReachingIn(bb->index, [&](StoreInst const* store) {
+                            out.print(" ", store->into.view(), "=", store->from.view());
+                        });
+                        out.put("\\n");
+                    }
+                }
+            }
+            if (showLiveness) {
+                out.put("live-out:");
+                liveness().forEachLiveOut(bb->index, [&](uint32_t reg) { out.print(" ", ssa.slots[reg].name.view()); });
+                out.put("\\n");
+            }
+            out.put("\"]\n");
+            if (dyn_cast<RetInst>(bb->terminatorInst)) {
+                out.print(bb->label(), "-->EXIT");
+            }
+            bool first = true;
+            for (auto succ : graph.successors(bb->index)) {
+                if (!std::exchange(first, false)) out.put('\n');
+                out.print(bb->label(), "-->", bbs[succ]->label());
+            }
+            out.put('\n');
         }
-        buf += "\n```\n";
-        return buf;
+        out.put("\n```\n");
     }
 };
 
-}
\ No newline at end of file
+}
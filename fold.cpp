@@ -0,0 +1,150 @@
+#include "fold.hpp"
+
+#include <cmath>
+
+namespace YAOPT {
+
+std::optional<Constant> fold(Opcode op, Constant lhs, Constant rhs) noexcept {
+    Type type = lhs.type;
+    if (type != rhs.type) return std::nullopt;
+    bool floating = type == Type::DOUBLE;
+    uint64_t a = lhs.bits, b = rhs.bits;
+    int64_t sa = lhs.asSigned(), sb = rhs.asSigned();
+    unsigned width = type == Type::I1 ? 1 : 64;
+    double x = lhs.asDouble(), y = rhs.asDouble();
+    switch (op) {
+        case Opcode::FADD:
+            if (floating) return Constant::ofDouble(x + y);
+            break;
+        case Opcode::FSUB:
+            if (floating) return Constant::ofDouble(x - y);
+            break;
+        case Opcode::FMUL:
+            if (floating) return Constant::ofDouble(x * y);
+            break;
+        case Opcode::FDIV:
+            if (floating) return Constant::ofDouble(x / y);
+            break;
+        case Opcode::FREM:
+            if (floating) return Constant::ofDouble(std::fmod(x, y));
+            break;
+        default:
+            break;
+    }
+    if (type != Type::I1 && type != Type::I64) return std::nullopt;
+    int64_t min = type == Type::I1 ? -1 : INT64_MIN;
+    switch (op) {
+        case Opcode::ADD:
+            return Constant::ofInt(type, a + b);
+        case Opcode::SUB:
+            return Constant::ofInt(type, a - b);
+        case Opcode::MUL:
+            return Constant::ofInt(type, a * b);
+        case Opcode::UDIV:
+            if (b == 0) return std::nullopt;
+            return Constant::ofInt(type, a / b);
+        case Opcode::UREM:
+            if (b == 0) return std::nullopt;
+            return Constant::ofInt(type, a % b);
+        case Opcode::SDIV:
+            if (sb == 0 || (sa == min && sb == -1)) return std::nullopt;
+            return Constant::ofInt(type, uint64_t(sa / sb));
+        case Opcode::SREM:
+            if (sb == 0 || (sa == min && sb == -1)) return std::nullopt;
+            return Constant::ofInt(type, uint64_t(sa % sb));
+        case Opcode::SHL:
+            if (b >= width) return std::nullopt;
+            return Constant::ofInt(type, a << b);
+        case Opcode::LSHR:
+            if (b >= width) return std::nullopt;
+            return Constant::ofInt(type, a >> b);
+        case Opcode::ASHR:
+            if (b >= width) return std::nullopt;
+            return Constant::ofInt(type, uint64_t(sa >> b));
+        case Opcode::AND:
+            return Constant::ofInt(type, a & b);
+        case Opcode::OR:
+            return Constant::ofInt(type, a | b);
+        case Opcode::XOR:
+            return Constant::ofInt(type, a ^ b);
+        default:
+            return std::nullopt;
+    }
+}
+
+std::optional<Constant> fold(IcmpInst::Op op, Constant lhs, Constant rhs) noexcept {
+    if (lhs.type != rhs.type || lhs.type == Type::DOUBLE) return std::nullopt;
+    uint64_t a = lhs.bits, b = rhs.bits;
+    int64_t sa = lhs.asSigned(), sb = rhs.asSigned();
+    switch (op) {
+        case IcmpInst::Op::EQ: return Constant::ofBool(a == b);
+        case IcmpInst::Op::NE: return Constant::ofBool(a != b);
+        case IcmpInst::Op::SLT: return Constant::ofBool(sa < sb);
+        case IcmpInst::Op::ULT: return Constant::ofBool(a < b);
+        case IcmpInst::Op::SLE: return Constant::ofBool(sa <= sb);
+        case IcmpInst::Op::ULE: return Constant::ofBool(a <= b);
+        case IcmpInst::Op::SGT: return Constant::ofBool(sa > sb);
+        case IcmpInst::Op::UGT: return Constant::ofBool(a > b);
+        case IcmpInst::Op::SGE: return Constant::ofBool(sa >= sb);
+        case IcmpInst::Op::UGE: return Constant::ofBool(a >= b);
+    }
+    return std::nullopt;
+}
+
+std::optional<Constant> fold(FcmpInst::Op op, Constant lhs, Constant rhs) noexcept {
+    if (lhs.type != Type::DOUBLE || rhs.type != Type::DOUBLE) return std::nullopt;
+    double x = lhs.asDouble(), y = rhs.asDouble();
+    bool unordered = std::isnan(x) || std::isnan(y);
+    switch (op) {
+        case FcmpInst::Op::FALSE: return Constant::ofBool(false);
+        case FcmpInst::Op::OEQ: return Constant::ofBool(!unordered && x == y);
+        case FcmpInst::Op::OGT: return Constant::ofBool(!unordered && x > y);
+        case FcmpInst::Op::OGE: return Constant::ofBool(!unordered && x >= y);
+        case FcmpInst::Op::OLT: return Constant::ofBool(!unordered && x < y);
+        case FcmpInst::Op::OLE: return Constant::ofBool(!unordered && x <= y);
+        case FcmpInst::Op::ONE: return Constant::ofBool(!unordered && x != y);
+        case FcmpInst::Op::ORD: return Constant::ofBool(!unordered);
+        case FcmpInst::Op::UEQ: return Constant::ofBool(unordered || x == y);
+        case FcmpInst::Op::UGT: return Constant::ofBool(unordered || x > y);
+        case FcmpInst::Op::UGE: return Constant::ofBool(unordered || x >= y);
+        case FcmpInst::Op::ULT: return Constant::ofBool(unordered || x < y);
+        case FcmpInst::Op::ULE: return Constant::ofBool(unordered || x <= y);
+        case FcmpInst::Op::UNE: return Constant::ofBool(unordered || x != y);
+        case FcmpInst::Op::UNO: return Constant::ofBool(unordered);
+        case FcmpInst::Op::TRUE: return Constant::ofBool(true);
+    }
+    return std::nullopt;
+}
+
+std::optional<Constant> fold(Opcode op, Constant value, Type to) noexcept {
+    switch (op) {
+        case Opcode::SITOFP:
+            if (value.type != Type::I1 && value.type != Type::I64) return std::nullopt;
+            return Constant::ofDouble(double(value.asSigned()));
+        case Opcode::FPTOSI: {
+            if (value.type != Type::DOUBLE) return std::nullopt;
+            double truncated = std::trunc(value.asDouble());
+            if (to == Type::I1) {
+                if (truncated != 0 && truncated != -1) return std::nullopt;
+                return Constant::ofBool(truncated == -1);
+            }
+            // NaN fails both comparisons, so it is rejected along with out-of-range values.
+            if (to != Type::I64 || !(truncated >= -0x1p63 && truncated < 0x1p63)) return std::nullopt;
+            return Constant::ofInt(Type::I64, uint64_t(int64_t(truncated)));
+        }
+        case Opcode::INTTOPTR:
+            if (value.type != Type::I64 || to != Type::PTR) return std::nullopt;
+            return Constant{Type::PTR, value.bits};
+        case Opcode::PTRTOINT:
+            if (value.type != Type::PTR || to != Type::I64) return std::nullopt;
+            return Constant::ofInt(Type::I64, value.bits);
+        default:
+            return std::nullopt;
+    }
+}
+
+Constant fneg(Constant value) noexcept {
+    return {value.type, value.bits ^ uint64_t(1) << 63};
+}
+
+}
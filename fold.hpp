@@ -0,0 +1,16 @@
+#pragma once
+
+#include <optional>
+
+#include "inst.hpp"
+
+namespace YAOPT {
+
+// Each fold returns std::nullopt where LLVM would produce poison or undefined behaviour, so callers never fold those.
+[[nodiscard]] std::optional<Constant> fold(Opcode op, Constant lhs, Constant rhs) noexcept;
+[[nodiscard]] std::optional<Constant> fold(IcmpInst::Op op, Constant lhs, Constant rhs) noexcept;
+[[nodiscard]] std::optional<Constant> fold(FcmpInst::Op op, Constant lhs, Constant rhs) noexcept;
+[[nodiscard]] std::optional<Constant> fold(Opcode op, Constant value, Type to) noexcept;
+[[nodiscard]] Constant fneg(Constant value) noexcept;
+
+}
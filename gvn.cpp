@@ -0,0 +1,176 @@
+#include "gvn.hpp"
+
+#include <unordered_map>
+
+namespace YAOPT {
+
+namespace {
+
+struct Expression {
+    uint32_t op;
+    uint32_t types;
+    uint64_t lhs, rhs;
+
+    bool operator==(Expression const&) const noexcept = default;
+};
+
+struct ExpressionHash {
+    size_t operator()(Expression const& e) const noexcept {
+        uint64_t h = (uint64_t(e.op) << 32 | e.types) * 0x9E3779B97F4A7C15;
+        h = (h ^ e.lhs) * 0xFF51AFD7ED558CCD;
+        h = (h ^ e.rhs) * 0xC4CEB9FE1A85EC53;
+        return h ^ h >> 32;
+    }
+};
+
+enum Family : uint32_t {
+    BINARY = 1 << 8, ICMP = 2 << 8, FCMP = 3 << 8, CONV = 4 << 8, GEP = 5 << 8,
+};
+
+[[nodiscard]] constexpr bool commutative(Opcode op) noexcept {
+    switch (op) {
+        case Opcode::ADD:
+        case Opcode::FADD:
+        case Opcode::MUL:
+        case Opcode::FMUL:
+        case Opcode::AND:
+        case Opcode::OR:
+        case Opcode::XOR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// The predicate that holds for swapped operands.
+[[nodiscard]] constexpr IcmpInst::Op swapped(IcmpInst::Op op) noexcept {
+    using enum IcmpInst::Op;
+    switch (op) {
+        case SLT: return SGT;
+        case ULT: return UGT;
+        case SLE: return SGE;
+        case ULE: return UGE;
+        case SGT: return SLT;
+        case UGT: return ULT;
+        case SGE: return SLE;
+        case UGE: return ULE;
+        default: return op;
+    }
+}
+
+[[nodiscard]] constexpr FcmpInst::Op swapped(FcmpInst::Op op) noexcept {
+    using enum FcmpInst::Op;
+    switch (op) {
+        case OGT: return OLT;
+        case OGE: return OLE;
+        case OLT: return OGT;
+        case OLE: return OGE;
+        case UGT: return ULT;
+        case UGE: return ULE;
+        case ULT: return UGT;
+        case ULE: return UGE;
+        default: return op;
+    }
+}
+
+struct Numbering {
+    SSA& ssa;
+
+    // Registers are numbered by their current leader, constants by pool entry and other names by spelling.
+    [[nodiscard]] uint64_t operator()(Value const& value) noexcept {
+        if (value.reg == Value::NONE) return value.immediateKey();
+        uint32_t reg = ssa.find(value.reg);
+        if (ssa.slots[reg].immediate) return ssa.slots[reg].immediateKey();
+        return reg;
+    }
+
+    [[nodiscard]] std::optional<Expression> of(Inst* inst) noexcept {
+        auto types = [](Type a, Type b = Type::VOID) {
+            return uint32_t(a) << 8 | uint32_t(b);
+        };
+        if (auto binary = dyn_cast<BinaryOpInst>(inst)) {
+            Expression e{BINARY | uint32_t(binary->opcode), types(binary->type), (*this)(binary->value1), (*this)(binary->value2)};
+            if (commutative(binary->opcode) && e.rhs < e.lhs) std::swap(e.lhs, e.rhs);
+            return e;
+        }
+        if (auto icmp = dyn_cast<IcmpInst>(inst)) {
+            auto op = icmp->op;
+            uint64_t lhs = (*this)(icmp->value1), rhs = (*this)(icmp->value2);
+            if (rhs < lhs) std::swap(lhs, rhs), op = swapped(op);
+            return Expression{ICMP | uint32_t(op), types(icmp->type), lhs, rhs};
+        }
+        if (auto fcmp = dyn_cast<FcmpInst>(inst)) {
+            auto op = fcmp->op;
+            uint64_t lhs = (*this)(fcmp->value1), rhs = (*this)(fcmp->value2);
+            if (rhs < lhs) std::swap(lhs, rhs), op = swapped(op);
+            return Expression{FCMP | uint32_t(op), types(fcmp->type), lhs, rhs};
+        }
+        if (auto conv = dyn_cast<ConvInst>(inst)) {
+            return Expression{CONV | uint32_t(conv->opcode), types(conv->type1, conv->type2), (*this)(conv->value), 0};
+        }
+        if (auto gep = dyn_cast<GEPInst>(inst)) {
+            return Expression{GEP, types(gep->type), (*this)(gep->ptr), (*this)(gep->offset)};
+        }
+        return std::nullopt;
+    }
+};
+
+}
+
+PassResult gvn(FunctionDefine& define) {
+    if (define.bbs.empty()) return {};
+    auto& ssa = define.ssa;
+    auto& tree = define.dominators();
+    Numbering numbering{ssa};
+    std::unordered_map<Expression, uint32_t, ExpressionHash> available;
+    std::vector<Expression> scope;
+    std::vector<std::pair<uint32_t, size_t>> stack;
+    size_t removed = 0;
+
+    auto enter = [&](uint32_t block) {
+        stack.emplace_back(block, scope.size());
+        auto bb = define.bbs[block];
+        for (auto it = bb->insts.begin(); it != bb->insts.end();) {
+            auto inst = *it;
+            ++it;
+            if (inst->kind() != Inst::Kind::INTERMEDIATE) continue;
+            uint32_t number = static_cast<IntermediateInst*>(inst)->number;
+            if (number == Value::NONE) continue;
+            auto expression = numbering.of(inst);
+            if (!expression) continue;
+            auto [found, inserted] = available.try_emplace(*expression, number);
+            if (inserted) {
+                scope.push_back(*expression);
+                continue;
+            }
+            ssa.replaceAllUsesWith(number, found->second);
+            ssa.drop(inst);
+            bb->insts.erase(inst);
+            ++removed;
+        }
+    };
+
+    enter(tree.root);
+    std::vector<uint32_t> next{0};
+    while (!stack.empty()) {
+        auto [block, mark] = stack.back();
+        auto children = tree.children(block);
+        if (next.back() != children.size()) {
+            uint32_t child = children[next.back()++];
+            next.push_back(0);
+            enter(child);
+            continue;
+        }
+        while (scope.size() != mark) {
+            available.erase(scope.back());
+            scope.pop_back();
+        }
+        stack.pop_back();
+        next.pop_back();
+    }
+    if (!removed) return {};
+    ssa.flush();
+    return {removed, Changed::VALUES};
+}
+
+}
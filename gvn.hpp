@@ -0,0 +1,12 @@
+#pragma once
+
+#include "entity.hpp"
+
+namespace YAOPT {
+
+// Dominator-scoped value numbering over binary ops, compares, casts and getelementptr: an instruction
+// that recomputes an expression already available in a dominating block is replaced by the earlier one.
+// Reports the number of instructions it removed.
+PassResult gvn(FunctionDefine& define);
+
+}
@@ -0,0 +1,64 @@
+#include "input.hpp"
+#include "util.hpp"
+
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace YAOPT {
+
+Input::Input(Input&& other) noexcept:
+        text(std::move(other.text)),
+        mapping(std::exchange(other.mapping, nullptr)),
+        length(std::exchange(other.length, 0)),
+        released(std::exchange(other.released, 0)) {}
+
+Input::~Input() {
+#ifndef _WIN32
+    if (mapping) munmap(mapping, length);
+#endif
+}
+
+void Input::release(const char* end) noexcept {
+#ifndef _WIN32
+    if (!mapping) return;
+    static const size_t page = sysconf(_SC_PAGESIZE);
+    auto begin = static_cast<const char*>(mapping);
+    size_t size = (end - begin) / page * page;
+    if (size > released) {
+        madvise(const_cast<char*>(begin) + released, size - released, MADV_DONTNEED);
+        released = size;
+    }
+#endif
+}
+
+Input Input::map(const char* filename) {
+#ifndef _WIN32
+    FILE* file = open(filename, "r");
+    struct stat info{};
+    if (fstat(fileno(file), &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        size_t size = info.st_size;
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+        if (mapping != MAP_FAILED) {
+            fclose(file);
+            madvise(mapping, size, MADV_SEQUENTIAL);
+            Input input;
+            input.mapping = mapping;
+            input.length = size;
+            return input;
+        }
+    }
+    fclose(file);
+#endif
+    return read(filename);
+}
+
+Input Input::read(const char* filename) {
+    return Input(readText(filename));
+}
+
+}
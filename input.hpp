@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace YAOPT {
+
+struct Input {
+    Input() = default;
+    explicit Input(std::string text): text(std::move(text)) {}
+    Input(Input&& other) noexcept;
+    Input& operator=(Input&&) = delete;
+    ~Input();
+
+    static Input map(const char* filename);
+    static Input read(const char* filename);
+
+    [[nodiscard]] std::string_view view() const noexcept {
+        if (mapping) return {static_cast<const char*>(mapping), length};
+        return text;
+    }
+
+    // Gives the pages of a mapped input that lie wholly before `end` back to the system. They must not be
+    // read again. Has no effect on an input that was read into memory.
+    void release(const char* end) noexcept;
+
+private:
+    std::string text;
+    void* mapping = nullptr;
+    size_t length = 0;
+    size_t released = 0;
+};
+
+}
@@ -5,105 +5,326 @@
 #include <memory>
 #include <cassert>
 #include <optional>
+#include <array>
+#include <span>
+#include <vector>
 #include "opcode.hpp"
+#include "keyword.hpp"
+#include "symbol.hpp"
+#include "util.hpp"
+#include "sink.hpp"
+#include "constant.hpp"
 
 namespace YAOPT {
 
+struct BasicBlock;
+
 struct Descriptor {
-    [[nodiscard]] virtual std::string serialize() const = 0;
+    virtual void serialize(Sink& out) const = 0;
     virtual ~Descriptor() = default;
 };
 
+// An operand: a register or other name spelled by `literal`, or an entry of the constant pool. Once
+// resolved, a register operand also carries its SSA slot in `reg`.
 struct Value {
-    std::string literal;
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    Symbol literal;
+    uint32_t reg = NONE;
+    uint32_t constant = NONE;
 
     Value() = default;
     Value(std::string_view literal): literal(literal) {}
+    explicit Value(Symbol literal): literal(literal) {}
 
-    [[nodiscard]] bool is_reg() const { return literal.starts_with('%'); }
-    [[nodiscard]] bool is_imm() const { return !is_reg(); }
-};
+    [[nodiscard]] static Value ofConstant(uint32_t constant) noexcept {
+        Value value;
+        value.constant = constant;
+        return value;
+    }
 
-enum class Type {
-    VOID, I1, I64, DOUBLE, PTR, LABEL
+    [[nodiscard]] std::string_view view() const noexcept {
+        return constant != NONE ? ConstantPool::at(constant).text : literal.view();
+    }
+    [[nodiscard]] bool is_reg() const { return constant == NONE && view().starts_with('%'); }
+    [[nodiscard]] bool is_imm() const { return !is_reg(); }
+    // Tells apart operands that are not registers: constants by pool entry, anything else by spelling.
+    [[nodiscard]] uint64_t immediateKey() const noexcept {
+        return constant != NONE ? uint64_t(2) << 32 | constant : uint64_t(1) << 32 | literal.id;
+    }
 };
 
-struct Inst : Descriptor {
-    std::string code;
+// Every instruction carries the opcode of its concrete class, so kind(), isa<>, cast<>, dyn_cast<> and visit()
+// test a plain field instead of going through the vtable or RTTI. Each class answers classof() from it.
+struct Inst {
+    Inst* prev = nullptr;
+    Inst* next = nullptr;
+    const Opcode opcode;
 
     enum class Kind {
         LABEL, INTERMEDIATE, TERMINATOR
     };
-    [[nodiscard]] virtual Kind kind() const = 0;
-    [[nodiscard]] std::string serialize() const override {
-        return code;
+    [[nodiscard]] Kind kind() const noexcept {
+        if (opcode == Opcode::LABEL) return Kind::LABEL;
+        return opcode >= Opcode::UNREACHABLE ? Kind::TERMINATOR : Kind::INTERMEDIATE;
+    }
+    virtual void serialize(Sink& out) const = 0;
+    virtual void forEachOperand(FunctionRef<void(Value&)>) {}
+
+protected:
+    explicit Inst(Opcode opcode): opcode(opcode) {}
+    ~Inst() = default;
+
+    [[nodiscard]] static constexpr bool between(Inst const* inst, Opcode first, Opcode last) noexcept {
+        return inst->opcode >= first && inst->opcode <= last;
+    }
+};
+
+template<typename T>
+[[nodiscard]] bool isa(Inst const* inst) noexcept {
+    return T::classof(inst);
+}
+
+template<typename T>
+[[nodiscard]] T* cast(Inst* inst) noexcept {
+    assert(isa<T>(inst));
+    return static_cast<T*>(inst);
+}
+
+template<typename T>
+[[nodiscard]] T const* cast(Inst const* inst) noexcept {
+    assert(isa<T>(inst));
+    return static_cast<T const*>(inst);
+}
+
+// Unlike its LLVM namesake, accepts a null instruction and returns null for it, as dynamic_cast does.
+template<typename T>
+[[nodiscard]] T* dyn_cast(Inst* inst) noexcept {
+    return inst && isa<T>(inst) ? static_cast<T*>(inst) : nullptr;
+}
+
+template<typename T>
+[[nodiscard]] T const* dyn_cast(Inst const* inst) noexcept {
+    return inst && isa<T>(inst) ? static_cast<T const*>(inst) : nullptr;
+}
+
+struct InstList {
+    Inst* head = nullptr;
+    Inst* tail = nullptr;
+
+    struct iterator {
+        Inst* inst;
+
+        Inst* operator*() const noexcept { return inst; }
+        iterator& operator++() noexcept { inst = inst->next; return *this; }
+        bool operator==(iterator const&) const noexcept = default;
+    };
+
+    [[nodiscard]] iterator begin() const noexcept { return {head}; }
+    [[nodiscard]] iterator end() const noexcept { return {nullptr}; }
+    [[nodiscard]] bool empty() const noexcept { return !head; }
+
+    void push_back(Inst* inst) noexcept {
+        inst->prev = tail;
+        inst->next = nullptr;
+        (tail ? tail->next : head) = inst;
+        tail = inst;
+    }
+
+    void insert(Inst* before, Inst* inst) noexcept {
+        if (!before) return push_back(inst);
+        inst->prev = before->prev;
+        inst->next = before;
+        (before->prev ? before->prev->next : head) = inst;
+        before->prev = inst;
+    }
+
+    void erase(Inst* inst) noexcept {
+        (inst->prev ? inst->prev->next : head) = inst->next;
+        (inst->next ? inst->next->prev : tail) = inst->prev;
+        inst->prev = inst->next = nullptr;
     }
 };
 
 struct LabelInst : Inst {
-    std::string label;
-    explicit LabelInst(std::string label): label(std::move(label)) {}
+    Symbol label;
+    explicit LabelInst(Symbol label): Inst(Opcode::LABEL), label(label) {}
 
-    [[nodiscard]] Kind kind() const override {
-        return Inst::Kind::LABEL;
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::LABEL;
+    }
+    void serialize(Sink& out) const override {
+        out.print(label.view(), ":");
     }
 };
 
 struct IntermediateInst : Inst {
-    std::optional<std::string> receiver;
-    [[nodiscard]] Kind kind() const override {
-        return Inst::Kind::INTERMEDIATE;
+    Symbol receiver;
+    uint32_t number = Value::NONE;
+
+    explicit IntermediateInst(Opcode opcode): Inst(opcode) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return between(inst, Opcode::FNEG, Opcode::PHI);
+    }
+    void assignment(Sink& out) const {
+        if (!receiver.empty()) out.print(receiver.view(), " = ");
     }
 };
 
 struct OpInst : IntermediateInst {
+    using IntermediateInst::IntermediateInst;
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return between(inst, Opcode::FNEG, Opcode::XOR);
+    }
 };
 
 struct UnaryOpInst : OpInst {
     inline static const Type type = Type::DOUBLE;
     Value value;
-    explicit UnaryOpInst(Value value): value(std::move(value)) {}
+    explicit UnaryOpInst(Value value): OpInst(Opcode::FNEG), value(std::move(value)) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::FNEG;
+    }
+
+    void forEachOperand(FunctionRef<void(Value&)> f) override {
+        f(value);
+    }
+
+    void serialize(Sink& out) const override {
+        assignment(out);
+        out.print("fneg double ", value.view());
+    }
 };
 
 struct BinaryOpInst : OpInst {
-    Opcode op;
     Type type;
     Value value1, value2;
     BinaryOpInst(Opcode op, Type type, Value value1, Value value2):
-        op(op), type(type), value1(std::move(value1)), value2(std::move(value2)) {}
+        OpInst(op), type(type), value1(std::move(value1)), value2(std::move(value2)) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return between(inst, Opcode::ADD, Opcode::XOR);
+    }
+
+    void forEachOperand(FunctionRef<void(Value&)> f) override {
+        f(value1);
+        f(value2);
+    }
+
+    void serialize(Sink& out) const override {
+        assignment(out);
+        out.print(OPCODE_NAME[size_t(opcode)], " ", nameOf(type), " ", value1.view(), ", ", value2.view());
+    }
 };
 
-struct MemInst : IntermediateInst {};
+struct MemInst : IntermediateInst {
+    // The ", align <n>" of an alloca, load or store; 0 when the line gave none.
+    uint32_t align = 0;
+
+    using IntermediateInst::IntermediateInst;
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return between(inst, Opcode::ALLOCA, Opcode::GETELEMENTPTR);
+    }
+    void alignment(Sink& out) const {
+        if (align) out.print(", align ", std::to_string(align));
+    }
+};
 
 struct AllocaInst : MemInst {
     Type type;
-    explicit AllocaInst(Type type): type(type) {}
+    explicit AllocaInst(Type type): MemInst(Opcode::ALLOCA), type(type) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::ALLOCA;
+    }
+
+    void serialize(Sink& out) const override {
+        assignment(out);
+        out.print("alloca ", nameOf(type));
+        alignment(out);
+    }
 };
 
 struct LoadInst : MemInst {
     Type type; Value from;
 
-    LoadInst(Type type, Value from) : type(type), from(std::move(from)) {}
+    LoadInst(Type type, Value from) : MemInst(Opcode::LOAD), type(type), from(std::move(from)) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::LOAD;
+    }
+
+    void forEachOperand(FunctionRef<void(Value&)> f) override {
+        f(from);
+    }
+
+    void serialize(Sink& out) const override {
+        assignment(out);
+        out.print("load ", nameOf(type), ", ptr ", from.view());
+        alignment(out);
+    }
 };
 
 struct StoreInst : MemInst {
     Type type; Value from, into;
 
-    StoreInst(Type type, Value from, Value into) : type(type), from(std::move(from)), into(std::move(into)) {}
+    StoreInst(Type type, Value from, Value into) : MemInst(Opcode::STORE), type(type), from(std::move(from)), into(std::move(into)) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::STORE;
+    }
+
+    void forEachOperand(FunctionRef<void(Value&)> f) override {
+        f(from);
+        f(into);
+    }
+
+    void serialize(Sink& out) const override {
+        assignment(out);
+        out.print("store ", nameOf(type), " ", from.view(), ", ptr ", into.view());
+        alignment(out);
+    }
 };
 
 struct GEPInst : MemInst {
     Type type; Value ptr, offset;
 
-    GEPInst(Type type, Value ptr, Value offset) : type(type), ptr(std::move(ptr)), offset(std::move(offset)) {}
+    GEPInst(Type type, Value ptr, Value offset) : MemInst(Opcode::GETELEMENTPTR), type(type), ptr(std::move(ptr)), offset(std::move(offset)) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::GETELEMENTPTR;
+    }
+
+    void forEachOperand(FunctionRef<void(Value&)> f) override {
+        f(ptr);
+        f(offset);
+    }
+
+    void serialize(Sink& out) const override {
+        assignment(out);
+        out.print("getelementptr inbounds ", nameOf(type), ", ptr ", ptr.view(), ", i64 ", offset.view());
+    }
 };
 
 struct CmpInst : IntermediateInst {
     Type type;
     Value value1, value2;
 
-    CmpInst(Type type, Value value1, Value value2) : type(type), value1(std::move(value1)), value2(std::move(value2)) {}
+    CmpInst(Opcode opcode, Type type, Value value1, Value value2) :
+            IntermediateInst(opcode), type(type), value1(std::move(value1)), value2(std::move(value2)) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return between(inst, Opcode::ICMP, Opcode::FCMP);
+    }
 
+    void forEachOperand(FunctionRef<void(Value&)> f) override {
+        f(value1);
+        f(value2);
+    }
 };
 
 struct IcmpInst : CmpInst {
@@ -116,20 +337,22 @@ struct IcmpInst : CmpInst {
     };
     Op op;
 
-    inline static const std::unordered_map<std::string_view, Op> OPS {
-            {"eq", Op::EQ},
-            {"ne", Op::NE},
-            {"slt", Op::SLT},
-            {"ult", Op::ULT},
-            {"sle", Op::SLE},
-            {"ule", Op::ULE},
-            {"sgt", Op::SGT},
-            {"ugt", Op::UGT},
-            {"sge", Op::SGE},
-            {"uge", Op::UGE},
-    };
+    [[nodiscard]] static constexpr std::optional<Op> of(Keyword keyword) noexcept {
+        if (keyword < Keyword::EQ || keyword > Keyword::UGE) return std::nullopt;
+        return Op(size_t(keyword) - size_t(Keyword::EQ));
+    }
 
-    IcmpInst(Type type, const Value &value1, const Value &value2, Op op) : CmpInst(type, value1, value2), op(op) {}
+    IcmpInst(Type type, const Value &value1, const Value &value2, Op op) : CmpInst(Opcode::ICMP, type, value1, value2), op(op) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::ICMP;
+    }
+
+    void serialize(Sink& out) const override {
+        assignment(out);
+        out.print("icmp ", KEYWORD_NAME[size_t(Keyword::EQ) + size_t(op)], " ", nameOf(type), " ",
+                  value1.view(), ", ", value2.view());
+    }
 };
 
 struct FcmpInst : CmpInst {
@@ -153,36 +376,69 @@ struct FcmpInst : CmpInst {
     };
     Op op;
 
-    inline static const std::unordered_map<std::string_view, Op> OPS {
-            {"false", Op::FALSE},
-            {"oeq", Op::OEQ},
-            {"ogt", Op::OGT},
-            {"oge", Op::OGE},
-            {"olt", Op::OLT},
-            {"ole", Op::OLE},
-            {"one", Op::ONE},
-            {"ord", Op::ORD},
-            {"ueq", Op::UEQ},
-            {"ugt", Op::UGT},
-            {"uge", Op::UGE},
-            {"ult", Op::ULT},
-            {"ule", Op::ULE},
-            {"une", Op::UNE},
-            {"uno", Op::UNO},
-            {"true", Op::TRUE},
+    static constexpr Keyword KEYWORD[] = {
+            Keyword::FALSE,
+            Keyword::OEQ,
+            Keyword::OGT,
+            Keyword::OGE,
+            Keyword::OLT,
+            Keyword::OLE,
+            Keyword::ONE,
+            Keyword::ORD,
+            Keyword::UEQ,
+            Keyword::UGT,
+            Keyword::UGE,
+            Keyword::ULT,
+            Keyword::ULE,
+            Keyword::UNE,
+            Keyword::UNO,
+            Keyword::TRUE,
     };
 
-    FcmpInst(Type type, const Value &value1, const Value &value2, Op op) : CmpInst(type, value1, value2), op(op) {}
+    [[nodiscard]] static constexpr std::optional<Op> of(Keyword keyword) noexcept {
+        constexpr auto OPS = [] {
+            std::array<int8_t, KEYWORD_COUNT> table{};
+            table.fill(-1);
+            for (size_t i = 0; i < std::size(KEYWORD); ++i) table[size_t(KEYWORD[i])] = int8_t(i);
+            return table;
+        }();
+        if (OPS[size_t(keyword)] < 0) return std::nullopt;
+        return Op(OPS[size_t(keyword)]);
+    }
+
+    FcmpInst(Type type, const Value &value1, const Value &value2, Op op) : CmpInst(Opcode::FCMP, type, value1, value2), op(op) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::FCMP;
+    }
+
+    void serialize(Sink& out) const override {
+        assignment(out);
+        out.print("fcmp ", KEYWORD_NAME[size_t(KEYWORD[size_t(op)])], " ", nameOf(type), " ",
+                  value1.view(), ", ", value2.view());
+    }
 
 };
 
 struct ConvInst : IntermediateInst {
-    Opcode op;
     Type type1, type2;
     Value value;
 
-    ConvInst(Opcode op, Type type1, Type type2, Value value) : op(op), type1(type1), type2(type2),
+    ConvInst(Opcode op, Type type1, Type type2, Value value) : IntermediateInst(op), type1(type1), type2(type2),
                                                                       value(std::move(value)) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return between(inst, Opcode::SITOFP, Opcode::PTRTOINT);
+    }
+
+    void forEachOperand(FunctionRef<void(Value&)> f) override {
+        f(value);
+    }
+
+    void serialize(Sink& out) const override {
+        assignment(out);
+        out.print(OPCODE_NAME[size_t(opcode)], " ", nameOf(type1), " ", value.view(), " to ", nameOf(type2));
+    }
 };
 
 struct CallInst : IntermediateInst {
@@ -191,49 +447,204 @@ struct CallInst : IntermediateInst {
     };
 
     Type ret_type; Value function;
-    std::vector<TypedValue> args;
+    std::span<TypedValue> args;
 
-    CallInst(Type ret_type, Value function, const std::vector<TypedValue> &args):
-            ret_type(ret_type), function(std::move(function)), args(args) {}
+    CallInst(Type ret_type, Value function, std::span<TypedValue> args):
+            IntermediateInst(Opcode::CALL), ret_type(ret_type), function(std::move(function)), args(args) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::CALL;
+    }
+
+    void forEachOperand(FunctionRef<void(Value&)> f) override {
+        f(function);
+        for (auto&& arg : args) f(arg.value);
+    }
+
+    void serialize(Sink& out) const override {
+        assignment(out);
+        out.print("call ", nameOf(ret_type), " ", function.view(), "(");
+        for (auto&& arg : args) {
+            if (&arg != args.data()) out.put(", ");
+            out.print(nameOf(arg.type), " ", arg.value.view());
+        }
+        out.put(')');
+    }
+};
+
+struct PhiInst : IntermediateInst {
+    struct Incoming {
+        Value value;
+        Symbol label;
+        BasicBlock* block = nullptr;
+    };
+
+    Type type;
+    std::span<Incoming> incoming;
+
+    PhiInst(Type type, std::span<Incoming> incoming): IntermediateInst(Opcode::PHI), type(type), incoming(incoming) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::PHI;
+    }
+
+    void forEachOperand(FunctionRef<void(Value&)> f) override {
+        for (auto&& in : incoming) f(in.value);
+    }
+
+    void serialize(Sink& out) const override {
+        assignment(out);
+        out.print("phi ", nameOf(type), " ");
+        for (auto&& in : incoming) {
+            if (&in != incoming.data()) out.put(", ");
+            out.print("[ ", in.value.view(), ", %", in.label.view(), " ]");
+        }
+    }
 };
 
 struct TerminatorInst : Inst {
-    [[nodiscard]] Kind kind() const override {
-        return Inst::Kind::TERMINATOR;
+    explicit TerminatorInst(Opcode opcode): Inst(opcode) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return between(inst, Opcode::UNREACHABLE, Opcode::BR_COND);
     }
-    [[nodiscard]] virtual std::string transition(const std::string& from) const = 0;
+    virtual void forEachTarget(FunctionRef<void(Symbol&, BasicBlock*&)>) {}
 };
 
 struct RetInst : TerminatorInst {
     Type type = Type::VOID;
     Value value;
 
-    [[nodiscard]] std::string transition(const std::string& from) const override {
-        return from + "-->EXIT";
+    RetInst(): TerminatorInst(Opcode::RET) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::RET;
+    }
+
+    void forEachOperand(FunctionRef<void(Value&)> f) override {
+        if (type != Type::VOID) f(value);
+    }
+    void serialize(Sink& out) const override {
+        if (type == Type::VOID) return out.put("ret void");
+        out.print("ret ", nameOf(type), " ", value.view());
     }
 };
 
 struct BrLabelInst : TerminatorInst {
-    std::string label;
-    [[nodiscard]] std::string transition(const std::string& from) const override {
-        return from + "-->" + label;
+    Symbol label;
+    BasicBlock* target = nullptr;
+
+    BrLabelInst(): TerminatorInst(Opcode::BR) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::BR;
+    }
+
+    void forEachTarget(FunctionRef<void(Symbol&, BasicBlock*&)> f) override {
+        f(label, target);
+    }
+    void serialize(Sink& out) const override {
+        out.print("br label %", label.view());
     }
 };
 
 struct BrCondInst : TerminatorInst {
     Type type = Type::I1;
     Value cond;
-    std::string label1, label2;
-    [[nodiscard]] std::string transition(const std::string& from) const override {
-        return from + "-->" + label1 + "\n" + from + "-->" + label2;
+    Symbol label1, label2;
+    BasicBlock* target1 = nullptr;
+    BasicBlock* target2 = nullptr;
+
+    BrCondInst(): TerminatorInst(Opcode::BR_COND) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::BR_COND;
+    }
+
+    void forEachOperand(FunctionRef<void(Value&)> f) override {
+        f(cond);
+    }
+    void forEachTarget(FunctionRef<void(Symbol&, BasicBlock*&)> f) override {
+        f(label1, target1);
+        f(label2, target2);
+    }
+    void serialize(Sink& out) const override {
+        out.print("br i1 ", cond.view(), ", label %", label1.view(), ", label %", label2.view());
     }
 };
 
 struct UnreachableInst : TerminatorInst {
-    [[nodiscard]] std::string transition(const std::string& from) const override {
-        return "";
+    UnreachableInst(): TerminatorInst(Opcode::UNREACHABLE) {}
+
+    [[nodiscard]] static bool classof(Inst const* inst) noexcept {
+        return inst->opcode == Opcode::UNREACHABLE;
+    }
+
+    void serialize(Sink& out) const override {
+        out.put("unreachable");
     }
 };
 
+// Calls `f` with `inst` cast to its concrete class. The switch on the opcode compiles to one jump table,
+// so this is the way to dispatch on every kind of instruction at once.
+template<typename F>
+decltype(auto) visit(Inst* inst, F&& f) {
+    switch (inst->opcode) {
+        case Opcode::FNEG:
+            return f(static_cast<UnaryOpInst*>(inst));
+        case Opcode::ADD:
+        case Opcode::FADD:
+        case Opcode::SUB:
+        case Opcode::FSUB:
+        case Opcode::MUL:
+        case Opcode::FMUL:
+        case Opcode::UDIV:
+        case Opcode::SDIV:
+        case Opcode::FDIV:
+        case Opcode::UREM:
+        case Opcode::SREM:
+        case Opcode::FREM:
+        case Opcode::SHL:
+        case Opcode::LSHR:
+        case Opcode::ASHR:
+        case Opcode::AND:
+        case Opcode::OR:
+        case Opcode::XOR:
+            return f(static_cast<BinaryOpInst*>(inst));
+        case Opcode::ALLOCA:
+            return f(static_cast<AllocaInst*>(inst));
+        case Opcode::LOAD:
+            return f(static_cast<LoadInst*>(inst));
+        case Opcode::STORE:
+            return f(static_cast<StoreInst*>(inst));
+        case Opcode::GETELEMENTPTR:
+            return f(static_cast<GEPInst*>(inst));
+        case Opcode::ICMP:
+            return f(static_cast<IcmpInst*>(inst));
+        case Opcode::FCMP:
+            return f(static_cast<FcmpInst*>(inst));
+        case Opcode::SITOFP:
+        case Opcode::FPTOSI:
+        case Opcode::INTTOPTR:
+        case Opcode::PTRTOINT:
+            return f(static_cast<ConvInst*>(inst));
+        case Opcode::CALL:
+            return f(static_cast<CallInst*>(inst));
+        case Opcode::PHI:
+            return f(static_cast<PhiInst*>(inst));
+        case Opcode::UNREACHABLE:
+            return f(static_cast<UnreachableInst*>(inst));
+        case Opcode::RET:
+            return f(static_cast<RetInst*>(inst));
+        case Opcode::BR:
+            return f(static_cast<BrLabelInst*>(inst));
+        case Opcode::BR_COND:
+            return f(static_cast<BrCondInst*>(inst));
+        case Opcode::LABEL:
+            return f(static_cast<LabelInst*>(inst));
+    }
+    unreachable();
+}
+
 
-}
\ No newline at end of file
+}
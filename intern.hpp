@@ -0,0 +1,212 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "arena.hpp"
+#include "diagnostics.hpp"
+
+namespace YAOPT {
+
+// Entries addressed by a dense index in lazily allocated chunks, found through lazily allocated directories,
+// so an entry never moves once it has room and reading one takes no lock. Room is made only up to `limit`
+// entries; past it, interning fails with a diagnostic naming what ran out.
+template<typename Entry>
+struct ChunkedTable {
+    static constexpr size_t CHUNK = 1 << 12, CHUNKS = 1 << 10, DIRECTORIES = 1 << 9;
+    static constexpr uint32_t CAPACITY = CHUNK * CHUNKS * DIRECTORIES;
+
+    // Makes room for entry `index`, given that every entry below it has room already.
+    void reserve(uint32_t index, const char* what, uint32_t limit = CAPACITY) {
+        if (index >= limit) Error().with(ErrorMessage().fatal().text(what)).raise();
+        auto& directory = directories[index / CHUNK / CHUNKS];
+        if (!directory) directory = std::make_unique<std::unique_ptr<Entry[]>[]>(CHUNKS);
+        auto& chunk = directory[index / CHUNK % CHUNKS];
+        if (!chunk) chunk = std::make_unique<Entry[]>(CHUNK);
+    }
+
+    [[nodiscard]] Entry& operator[](uint32_t index) noexcept {
+        return directories[index / CHUNK / CHUNKS][index / CHUNK % CHUNKS][index % CHUNK];
+    }
+    [[nodiscard]] Entry const& operator[](uint32_t index) const noexcept {
+        return directories[index / CHUNK / CHUNKS][index / CHUNK % CHUNKS][index % CHUNK];
+    }
+
+private:
+    std::array<std::unique_ptr<std::unique_ptr<Entry[]>[]>, DIRECTORIES> directories;
+};
+
+[[nodiscard]] inline std::string_view copyText(std::string_view text, Arena& arena) {
+    auto data = static_cast<char*>(arena.allocate(text.length(), 1));
+    std::memcpy(data, text.data(), text.length());
+    return {data, text.length()};
+}
+
+// Entries deduplicated by key in shards picked by hash, so threads interning at once seldom wait on the
+// same lock. `Traits` gives the Key, its Hash and the Entry, builds an entry with make(key, arena), copying
+// what it keeps into the arena, or refuses the key with std::nullopt, and gives back key(entry), which
+// points into the entry. An id is the index in its shard above SHARD_BITS bits of shard number.
+template<typename Traits>
+struct ShardedInterner {
+    using Key = typename Traits::Key;
+    using Hash = typename Traits::Hash;
+    using Entry = typename Traits::Entry;
+
+    static constexpr uint32_t NONE = UINT32_MAX;
+    static constexpr size_t SHARD_BITS = 4, SHARDS = 1 << SHARD_BITS;
+    // Entries per shard, so that ids leave the top bit clear.
+    static constexpr uint32_t LIMIT = (1u << (31 - SHARD_BITS)) - 1;
+
+    // The id of `key`, or NONE when make() refuses it.
+    [[nodiscard]] uint32_t intern(Key key) {
+        size_t shard = Hash{}(key) & (SHARDS - 1);
+        uint32_t local = shards[shard].intern(key);
+        return local == NONE ? NONE : local << SHARD_BITS | shard;
+    }
+
+    [[nodiscard]] Entry const& at(uint32_t id) const noexcept {
+        return shards[id & (SHARDS - 1)].entries[id >> SHARD_BITS];
+    }
+
+    [[nodiscard]] size_t size() noexcept {
+        size_t count = 0;
+        for (auto&& shard : shards) {
+            std::lock_guard lock(shard.mutex);
+            count += shard.size;
+        }
+        return count;
+    }
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<Key, uint32_t, Hash> index;
+        ChunkedTable<Entry> entries;
+        Arena text;
+        uint32_t size = 0;
+
+        uint32_t intern(Key key) {
+            std::lock_guard lock(mutex);
+            if (auto it = index.find(key); it != index.end()) return it->second;
+            std::optional<Entry> entry = Traits::make(key, text);
+            if (!entry) return NONE;
+            entries.reserve(size, Traits::WHAT, LIMIT);
+            entries[size] = *entry;
+            index.emplace(Traits::key(entries[size]), size);
+            return size++;
+        }
+    };
+
+    std::array<Shard, SHARDS> shards;
+};
+
+// Entries interned for one owner, such as a function, and given back when the scope goes away. Every scope of
+// the same Traits takes slots from one process-wide table and reuses the slots given back, so an entry is
+// read by slot alone. Each thread keeps a few spare slots to stay off the table lock. Text goes into an
+// arena of the owner, which must outlive the scope.
+template<typename Traits>
+struct ScopedInterner {
+    using Key = typename Traits::Key;
+    using Hash = typename Traits::Hash;
+    using Entry = typename Traits::Entry;
+
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    explicit ScopedInterner(Arena& text): text(text) {}
+    ScopedInterner(ScopedInterner const&) = delete;
+    ScopedInterner& operator=(ScopedInterner const&) = delete;
+    ~ScopedInterner() {
+        auto& free = spare();
+        for (auto&& [key, slot] : index) free.push(slot);
+    }
+
+    // The slot of `key`, or NONE when make() refuses it.
+    [[nodiscard]] uint32_t intern(Key key) {
+        if (auto it = index.find(key); it != index.end()) return it->second;
+        std::optional<Entry> entry = Traits::make(key, text);
+        if (!entry) return NONE;
+        uint32_t slot = spare().pop();
+        auto& entries = slots().entries;
+        entries[slot] = *entry;
+        index.emplace(Traits::key(entries[slot]), slot);
+        return slot;
+    }
+
+    [[nodiscard]] static Entry const& at(uint32_t slot) noexcept {
+        return slots().entries[slot];
+    }
+
+private:
+    static constexpr size_t BATCH = 64;
+    // Slots, so that a slot with the top bit set never equals NONE.
+    static constexpr uint32_t LIMIT = NONE >> 1;
+
+    struct Slots {
+        std::mutex mutex;
+        ChunkedTable<Entry> entries;
+        std::vector<uint32_t> free;
+        uint32_t size = 0;
+    };
+
+    static Slots& slots() {
+        static Slots slots;
+        return slots;
+    }
+
+    // Slots a thread holds between scopes; beyond two batches they go back to the table.
+    struct Spare {
+        std::vector<uint32_t> free;
+
+        ~Spare() {
+            give(free.size());
+        }
+
+        uint32_t pop() {
+            if (free.empty()) take();
+            uint32_t slot = free.back();
+            free.pop_back();
+            return slot;
+        }
+        void push(uint32_t slot) {
+            free.push_back(slot);
+            if (free.size() > BATCH * 2) give(BATCH);
+        }
+
+        void take() {
+            auto& table = slots();
+            std::lock_guard lock(table.mutex);
+            for (size_t i = 0; i < BATCH; ++i) {
+                if (table.free.empty()) {
+                    table.entries.reserve(table.size, Traits::WHAT, LIMIT);
+                    free.push_back(table.size++);
+                } else {
+                    free.push_back(table.free.back());
+                    table.free.pop_back();
+                }
+            }
+        }
+        void give(size_t count) {
+            auto& table = slots();
+            std::lock_guard lock(table.mutex);
+            table.free.insert(table.free.end(), free.end() - count, free.end());
+            free.resize(free.size() - count);
+        }
+    };
+
+    static Spare& spare() {
+        thread_local Spare spare;
+        return spare;
+    }
+
+    Arena& text;
+    std::unordered_map<Key, uint32_t, Hash> index;
+};
+
+}
@@ -0,0 +1,772 @@
+#include "interp.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace YAOPT {
+
+namespace {
+
+// Thrown by the bound @exit and caught in Interpreter::run, unwinding every interpreted frame.
+struct Exit {
+    uint64_t status;
+};
+
+#define YAOPT_INTERP_OPS(X) \
+    X(MOV) X(COPY) X(MASK) \
+    X(ADD) X(SUB) X(MUL) X(UDIV) X(SDIV) X(UREM) X(SREM) X(SHL) X(LSHR) X(ASHR) X(AND) X(OR) X(XOR) \
+    X(FADD) X(FSUB) X(FMUL) X(FDIV) X(FREM) X(FNEG) \
+    X(ICMP_EQ) X(ICMP_NE) X(ICMP_SLT) X(ICMP_ULT) X(ICMP_SLE) X(ICMP_ULE) \
+    X(ICMP_SGT) X(ICMP_UGT) X(ICMP_SGE) X(ICMP_UGE) \
+    X(FCMP_FALSE) X(FCMP_OEQ) X(FCMP_OGT) X(FCMP_OGE) X(FCMP_OLT) X(FCMP_OLE) X(FCMP_ONE) X(FCMP_ORD) \
+    X(FCMP_UEQ) X(FCMP_UGT) X(FCMP_UGE) X(FCMP_ULT) X(FCMP_ULE) X(FCMP_UNE) X(FCMP_UNO) X(FCMP_TRUE) \
+    X(SITOFP) X(SITOFP1) X(FPTOSI) \
+    X(ALLOCA) X(LOAD1) X(LOAD8) X(STORE1) X(STORE8) X(GEP) \
+    X(CALL) X(HOST) X(JUMP) X(BR) X(GOTO) X(RET) X(RET_VOID) X(UNREACHABLE) X(TRAP)
+
+enum Op : uint8_t {
+#define YAOPT_INTERP_ENUM(name) name,
+    YAOPT_INTERP_OPS(YAOPT_INTERP_ENUM)
+#undef YAOPT_INTERP_ENUM
+};
+
+constexpr size_t REGISTER_WORDS = size_t(1) << 20;
+constexpr size_t MEMORY_BYTES = size_t(8) << 20;
+constexpr size_t MAX_DEPTH = 10000;
+// Each global gets a zeroed cell of this many bytes with its initial value at the start, so code that
+// addresses past the scalar it declares still stays inside the cell.
+constexpr size_t GLOBAL_BYTES = 4096;
+
+}
+
+union Word {
+    void const* label;
+    Word const* target;
+    Interpreter::Code const* callee;
+    uint64_t operand;
+};
+
+struct Interpreter::Code {
+    FunctionDefine* define;
+    std::vector<Word> words;
+    std::vector<uint64_t> constants;
+    std::vector<std::string> messages;
+    uint32_t constantBase = 0, frameSize = 0;
+    Type returns = Type::VOID;
+    // Counter index of the call count; the counters of `edges` follow it in order.
+    size_t calls = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    std::vector<uint32_t> sizes;
+};
+
+struct Machine {
+    Interpreter* self = nullptr;
+    uint64_t* counters = nullptr;
+    uint64_t* registersEnd = nullptr;
+    std::byte* top = nullptr;
+    std::byte* limit = nullptr;
+    size_t depth = 0;
+
+    inline static void const* const* labels = nullptr;
+
+    static void prepare() {
+        if (!labels) Machine().execute(nullptr, nullptr);
+    }
+
+    [[noreturn]] static void trap(Interpreter::Code const* code, std::string_view what) {
+        throw Trap(join(what, " in ", code->define->name.view()));
+    }
+
+    uint64_t execute(Interpreter::Code const* code, uint64_t* frame);
+};
+
+uint64_t Machine::execute(Interpreter::Code const* code, uint64_t* frame) {
+#define YAOPT_INTERP_LABEL(name) &&L_##name,
+    static void const* const LABELS[] = {YAOPT_INTERP_OPS(YAOPT_INTERP_LABEL)};
+#undef YAOPT_INTERP_LABEL
+    if (!code) {
+        labels = LABELS;
+        return 0;
+    }
+    if (++depth > MAX_DEPTH) trap(code, "call stack overflow");
+    ++counters[code->calls];
+    std::byte* mark = top;
+    Word const* pc = code->words.data();
+
+#define DISPATCH goto *pc->label
+#define R(i) frame[pc[i].operand]
+#define F(i) std::bit_cast<double>(R(i))
+#define BINARY(name, expr) L_##name: { uint64_t a = R(2), b = R(3); R(1) = (expr); pc += 4; DISPATCH; }
+#define FBINARY(name, expr) L_##name: { double a = F(2), b = F(3); R(1) = std::bit_cast<uint64_t>(expr); pc += 4; DISPATCH; }
+#define COMPARE(name, type, expr) L_##name: { type a = std::bit_cast<type>(R(2)), b = std::bit_cast<type>(R(3)); R(1) = (expr); pc += 4; DISPATCH; }
+
+    DISPATCH;
+
+L_MOV:
+    R(1) = R(2);
+    pc += 3;
+    DISPATCH;
+L_COPY: {
+    uint64_t n = pc[1].operand;
+    for (uint64_t i = 0; i < n; ++i) R(2 + 2 * i) = R(3 + 2 * i);
+    pc += 2 + 2 * n;
+    DISPATCH;
+}
+L_MASK:
+    R(1) &= 1;
+    pc += 2;
+    DISPATCH;
+
+    BINARY(ADD, a + b)
+    BINARY(SUB, a - b)
+    BINARY(MUL, a * b)
+L_UDIV:
+    if (!R(3)) trap(code, "division by zero");
+    R(1) = R(2) / R(3);
+    pc += 4;
+    DISPATCH;
+L_SDIV:
+    if (!R(3)) trap(code, "division by zero");
+    if (int64_t(R(2)) == INT64_MIN && int64_t(R(3)) == -1) trap(code, "signed division overflow");
+    R(1) = uint64_t(int64_t(R(2)) / int64_t(R(3)));
+    pc += 4;
+    DISPATCH;
+L_UREM:
+    if (!R(3)) trap(code, "division by zero");
+    R(1) = R(2) % R(3);
+    pc += 4;
+    DISPATCH;
+L_SREM:
+    if (!R(3)) trap(code, "division by zero");
+    if (int64_t(R(2)) == INT64_MIN && int64_t(R(3)) == -1) trap(code, "signed division overflow");
+    R(1) = uint64_t(int64_t(R(2)) % int64_t(R(3)));
+    pc += 4;
+    DISPATCH;
+    // Shifts by 64 or more are poison; masking the amount keeps the host free of undefined behaviour.
+    BINARY(SHL, a << (b & 63))
+    BINARY(LSHR, a >> (b & 63))
+    BINARY(ASHR, uint64_t(int64_t(a) >> (b & 63)))
+    BINARY(AND, a & b)
+    BINARY(OR, a | b)
+    BINARY(XOR, a ^ b)
+
+    FBINARY(FADD, a + b)
+    FBINARY(FSUB, a - b)
+    FBINARY(FMUL, a * b)
+    FBINARY(FDIV, a / b)
+    FBINARY(FREM, std::fmod(a, b))
+L_FNEG:
+    R(1) = R(2) ^ uint64_t(1) << 63;
+    pc += 3;
+    DISPATCH;
+
+    COMPARE(ICMP_EQ, uint64_t, a == b)
+    COMPARE(ICMP_NE, uint64_t, a != b)
+    COMPARE(ICMP_SLT, int64_t, a < b)
+    COMPARE(ICMP_ULT, uint64_t, a < b)
+    COMPARE(ICMP_SLE, int64_t, a <= b)
+    COMPARE(ICMP_ULE, uint64_t, a <= b)
+    COMPARE(ICMP_SGT, int64_t, a > b)
+    COMPARE(ICMP_UGT, uint64_t, a > b)
+    COMPARE(ICMP_SGE, int64_t, a >= b)
+    COMPARE(ICMP_UGE, uint64_t, a >= b)
+
+    COMPARE(FCMP_FALSE, double, ((void) a, (void) b, false))
+    COMPARE(FCMP_OEQ, double, a == b)
+    COMPARE(FCMP_OGT, double, a > b)
+    COMPARE(FCMP_OGE, double, a >= b)
+    COMPARE(FCMP_OLT, double, a < b)
+    COMPARE(FCMP_OLE, double, a <= b)
+    COMPARE(FCMP_ONE, double, a < b || a > b)
+    COMPARE(FCMP_ORD, double, !std::isunordered(a, b))
+    COMPARE(FCMP_UEQ, double, std::isunordered(a, b) || a == b)
+    COMPARE(FCMP_UGT, double, !(a <= b))
+    COMPARE(FCMP_UGE, double, !(a < b))
+    COMPARE(FCMP_ULT, double, !(a >= b))
+    COMPARE(FCMP_ULE, double, !(a > b))
+    COMPARE(FCMP_UNE, double, a != b)
+    COMPARE(FCMP_UNO, double, std::isunordered(a, b))
+    COMPARE(FCMP_TRUE, double, ((void) a, (void) b, true))
+
+L_SITOFP:
+    R(1) = std::bit_cast<uint64_t>(double(int64_t(R(2))));
+    pc += 3;
+    DISPATCH;
+L_SITOFP1:
+    R(1) = std::bit_cast<uint64_t>(R(2) ? -1.0 : 0.0);
+    pc += 3;
+    DISPATCH;
+L_FPTOSI: {
+    // Out of range and NaN inputs are poison; they read as zero here.
+    double value = std::trunc(F(2));
+    R(1) = value >= -0x1p63 && value < 0x1p63 ? uint64_t(int64_t(value)) : 0;
+    pc += 3;
+    DISPATCH;
+}
+
+L_ALLOCA: {
+    uint64_t bytes = pc[2].operand;
+    if (bytes > uint64_t(limit - top)) trap(code, "stack memory exhausted");
+    R(1) = reinterpret_cast<uint64_t>(top);
+    top += bytes;
+    pc += 3;
+    DISPATCH;
+}
+L_LOAD1:
+    if (!R(2)) trap(code, "null pointer dereference");
+    R(1) = *reinterpret_cast<uint8_t const*>(R(2)) & 1;
+    pc += 3;
+    DISPATCH;
+L_LOAD8:
+    if (!R(2)) trap(code, "null pointer dereference");
+    std::memcpy(&R(1), reinterpret_cast<void const*>(R(2)), 8);
+    pc += 3;
+    DISPATCH;
+L_STORE1:
+    if (!R(2)) trap(code, "null pointer dereference");
+    *reinterpret_cast<uint8_t*>(R(2)) = uint8_t(R(1));
+    pc += 3;
+    DISPATCH;
+L_STORE8:
+    if (!R(2)) trap(code, "null pointer dereference");
+    std::memcpy(reinterpret_cast<void*>(R(2)), &R(1), 8);
+    pc += 3;
+    DISPATCH;
+L_GEP:
+    R(1) = R(2) + R(3) * pc[4].operand;
+    pc += 5;
+    DISPATCH;
+
+L_CALL: {
+    auto callee = pc[1].callee;
+    uint64_t argc = pc[3].operand;
+    uint64_t* next = frame + code->frameSize;
+    if (callee->frameSize > uint64_t(registersEnd - next)) trap(code, "call stack overflow");
+    for (uint64_t i = 0; i < argc; ++i) next[i] = R(4 + i);
+    std::memcpy(next + callee->constantBase, callee->constants.data(), callee->constants.size() * sizeof(uint64_t));
+    uint64_t result = execute(callee, next);
+    R(2) = result;
+    pc += 4 + argc;
+    DISPATCH;
+}
+L_HOST: {
+    auto host = self->hosts[pc[1].operand];
+    if (!host) trap(code, join("call to unbound function ", self->hostNames[pc[1].operand].view()));
+    uint64_t argc = pc[3].operand;
+    uint64_t* next = frame + code->frameSize;
+    if (argc > uint64_t(registersEnd - next)) trap(code, "call stack overflow");
+    for (uint64_t i = 0; i < argc; ++i) next[i] = R(4 + i);
+    R(2) = host({next, argc});
+    pc += 4 + argc;
+    DISPATCH;
+}
+L_JUMP:
+    ++counters[pc[1].operand];
+    pc = pc[2].target;
+    DISPATCH;
+L_BR:
+    if (R(1)) {
+        ++counters[pc[2].operand];
+        pc = pc[3].target;
+    } else {
+        ++counters[pc[4].operand];
+        pc = pc[5].target;
+    }
+    DISPATCH;
+L_GOTO:
+    pc = pc[1].target;
+    DISPATCH;
+L_RET:
+    top = mark;
+    --depth;
+    return R(1);
+L_RET_VOID:
+    top = mark;
+    --depth;
+    return 0;
+L_UNREACHABLE:
+    trap(code, "unreachable executed");
+L_TRAP:
+    trap(code, code->messages[pc[1].operand]);
+
+#undef COMPARE
+#undef FBINARY
+#undef BINARY
+#undef F
+#undef R
+#undef DISPATCH
+}
+
+namespace {
+
+[[nodiscard]] constexpr uint64_t sizeOf(Type type) noexcept {
+    return type == Type::I1 ? 1 : 8;
+}
+
+// Lowers one function to threaded code. Frames are laid out as parameters, values, a sink for unused
+// results, scratch for parallel phi copies and finally the constants, which every call copies in.
+struct Decoder {
+    Interpreter::Code& code;
+    FunctionDefine& define;
+    SSA& ssa;
+    std::unordered_map<Symbol, Interpreter::Code*> const& functions;
+    std::unordered_map<Symbol, std::unique_ptr<uint64_t[]>> const& globals;
+    FunctionRef<uint32_t(Symbol)> host;
+    size_t& counters;
+
+    std::vector<uint32_t> slots{};
+    std::unordered_map<uint64_t, uint32_t> constants{};
+    uint32_t sink = 0, scratch = 0;
+    std::vector<size_t> starts{};
+    // Words holding a branch target, with the block (or, past the blocks, the edge stub) they jump to.
+    std::vector<std::pair<size_t, size_t>> fixups{};
+    std::vector<std::pair<BasicBlock const*, BasicBlock const*>> stubs{};
+
+    void emit(Op op) {
+        code.words.push_back({.label = Machine::labels[op]});
+    }
+    void emit(uint64_t operand) {
+        code.words.push_back({.operand = operand});
+    }
+
+    [[noreturn]] void fail(std::string_view what) const {
+        throw Trap(join(what, " in ", define.name.view()));
+    }
+
+    [[nodiscard]] uint32_t operand(Value const& value, Type type) {
+        if (value.reg != Value::NONE) {
+            uint32_t slot = slots[ssa.find(value.reg)];
+            if (slot == Value::NONE) fail(join("use of undefined value ", value.view()));
+            return slot;
+        }
+        uint64_t key = value.immediateKey() << 8 | uint64_t(type);
+        auto [found, inserted] = constants.try_emplace(key, code.constantBase + code.constants.size());
+        if (inserted) code.constants.push_back(constant(value, type));
+        return found->second;
+    }
+
+    [[nodiscard]] uint64_t constant(Value const& value, Type type) const {
+        if (value.constant != Value::NONE) {
+            auto& entry = ConstantPool::at(value.constant);
+            if (entry.value.type == type) return entry.value.bits;
+        }
+        auto literal = value.view();
+        if (literal == "undef" || literal == "poison" || literal == "zeroinitializer") return 0;
+        if (type == Type::PTR && literal.starts_with('@')) {
+            auto global = globals.find(Symbol(literal));
+            if (global != globals.end()) {
+                if (!global->second) fail(join("unsupported global initializer of ", literal));
+                return reinterpret_cast<uint64_t>(global->second.get());
+            }
+            auto function = functions.find(Symbol(literal));
+            if (function != functions.end()) return reinterpret_cast<uint64_t>(function->second);
+        }
+        auto parsed = parseConstant(type, literal);
+        if (!parsed) fail(join("invalid ", nameOf(type), " constant ", literal));
+        return parsed->bits;
+    }
+
+    void decode() {
+        slots.assign(ssa.size(), Value::NONE);
+        uint32_t next = 0;
+        for (uint32_t i = 0; i < define.params.size(); ++i) slots[ssa.find(i)] = next++;
+        size_t phis = 0;
+        for (auto bb : define.bbs) {
+            size_t count = 0;
+            for (auto inst : bb->insts) {
+                if (inst->kind() != Inst::Kind::INTERMEDIATE) continue;
+                count += dyn_cast<PhiInst>(inst) != nullptr;
+                uint32_t number = static_cast<IntermediateInst*>(inst)->number;
+                if (number != Value::NONE) slots[ssa.find(number)] = next++;
+            }
+            phis = std::max(phis, count);
+        }
+        sink = next++;
+        scratch = next;
+        code.constantBase = next + phis;
+        code.calls = counters++;
+
+        starts.resize(define.bbs.size());
+        for (auto bb : define.bbs) {
+            starts[bb->index] = code.words.size();
+            uint32_t size = 0;
+            for (auto inst : bb->insts) {
+                if (isa<LabelInst>(inst)) continue;
+                ++size;
+                visit(inst, [&](auto concrete) { translate(bb, concrete); });
+            }
+            code.sizes.push_back(size);
+        }
+        for (size_t i = 0; i < stubs.size(); ++i) {
+            starts.push_back(code.words.size());
+            copies(stubs[i].first, stubs[i].second);
+            emit(GOTO);
+            fixups.emplace_back(code.words.size(), stubs[i].second->index);
+            emit(0);
+        }
+        for (auto [word, target] : fixups) {
+            code.words[word].target = code.words.data() + starts[target];
+        }
+        code.frameSize = code.constantBase + code.constants.size();
+    }
+
+    // Parallel copies of the phis of `to` along the edge from `from`; they go through scratch when a
+    // source is overwritten by an earlier copy.
+    void copies(BasicBlock const* from, BasicBlock const* to) {
+        std::vector<std::pair<uint32_t, uint32_t>> moves;
+        for (auto inst : to->insts) {
+            auto phi = dyn_cast<PhiInst>(inst);
+            if (!phi) continue;
+            if (phi->number == Value::NONE) continue;
+            for (auto&& in : phi->incoming) {
+                if (in.block != from) continue;
+                uint32_t dst = slots[ssa.find(phi->number)], src = operand(in.value, phi->type);
+                if (dst != src) moves.emplace_back(dst, src);
+                break;
+            }
+        }
+        if (moves.empty()) return;
+        bool overlap = false;
+        for (size_t i = 0; i < moves.size() && !overlap; ++i) {
+            for (size_t j = 0; j < i && !overlap; ++j) overlap = moves[i].second == moves[j].first;
+        }
+        if (overlap) {
+            emit(COPY);
+            emit(moves.size());
+            for (size_t i = 0; i < moves.size(); ++i) emit(scratch + i), emit(moves[i].second);
+            for (size_t i = 0; i < moves.size(); ++i) moves[i].second = scratch + i;
+        }
+        emit(COPY);
+        emit(moves.size());
+        for (auto [dst, src] : moves) emit(dst), emit(src);
+    }
+
+    [[nodiscard]] static bool hasPhi(BasicBlock const* bb) noexcept {
+        return bb->labelInst->next && dyn_cast<PhiInst>(bb->labelInst->next);
+    }
+
+    // Emits the counter and target words of one branch edge.
+    void edge(BasicBlock const* from, BasicBlock const* to) {
+        emit(counters++);
+        code.edges.emplace_back(from->index, to->index);
+        if (hasPhi(to)) {
+            fixups.emplace_back(code.words.size(), define.bbs.size() + stubs.size());
+            stubs.emplace_back(from, to);
+        } else {
+            fixups.emplace_back(code.words.size(), to->index);
+        }
+        emit(0);
+    }
+
+    void translate(BasicBlock const*, LabelInst*) {}
+
+    // Phis become parallel copies on the edges into their block.
+    void translate(BasicBlock const*, PhiInst*) {}
+
+    void translate(BasicBlock const*, RetInst* ret) {
+        code.returns = ret->type;
+        if (ret->type == Type::VOID) return emit(RET_VOID);
+        uint32_t value = operand(ret->value, ret->type);
+        emit(RET);
+        emit(value);
+    }
+
+    void translate(BasicBlock const* bb, BrLabelInst* br) {
+        emit(JUMP);
+        edge(bb, br->target);
+    }
+
+    void translate(BasicBlock const* bb, BrCondInst* br) {
+        uint32_t cond = operand(br->cond, Type::I1);
+        emit(BR);
+        emit(cond);
+        edge(bb, br->target1);
+        edge(bb, br->target2);
+    }
+
+    void translate(BasicBlock const*, UnreachableInst*) {
+        emit(UNREACHABLE);
+    }
+
+    void trap(std::string message) {
+        emit(TRAP);
+        emit(code.messages.size());
+        code.messages.push_back(std::move(message));
+    }
+
+    [[nodiscard]] uint32_t destination(IntermediateInst const* inst) const {
+        return inst->number != Value::NONE ? slots[ssa.find(inst->number)] : sink;
+    }
+
+    void translate(BasicBlock const*, BinaryOpInst* binary) {
+        uint32_t dst = destination(binary);
+        bool i1 = binary->type == Type::I1;
+        Op op;
+        switch (binary->opcode) {
+            case Opcode::ADD: op = ADD; break;
+            case Opcode::SUB: op = SUB; break;
+            case Opcode::MUL: op = MUL; break;
+            case Opcode::UDIV: op = UDIV; break;
+            case Opcode::SDIV: op = i1 ? UDIV : SDIV; break;
+            case Opcode::UREM: op = UREM; break;
+            case Opcode::SREM: op = i1 ? UREM : SREM; break;
+            case Opcode::SHL: op = SHL; break;
+            case Opcode::LSHR: op = LSHR; break;
+            case Opcode::ASHR: op = ASHR; break;
+            case Opcode::AND: op = AND; break;
+            case Opcode::OR: op = OR; break;
+            case Opcode::XOR: op = XOR; break;
+            case Opcode::FADD: op = FADD; break;
+            case Opcode::FSUB: op = FSUB; break;
+            case Opcode::FMUL: op = FMUL; break;
+            case Opcode::FDIV: op = FDIV; break;
+            case Opcode::FREM: op = FREM; break;
+            default: return trap("unsupported binary operator");
+        }
+        uint32_t a = operand(binary->value1, binary->type), b = operand(binary->value2, binary->type);
+        emit(op), emit(dst), emit(a), emit(b);
+        if (i1 && (op == ADD || op == SUB || op == MUL || op == SHL)) emit(MASK), emit(dst);
+    }
+
+    void translate(BasicBlock const*, UnaryOpInst* unary) {
+        uint32_t dst = destination(unary), a = operand(unary->value, Type::DOUBLE);
+        emit(FNEG), emit(dst), emit(a);
+    }
+
+    void translate(BasicBlock const*, IcmpInst* icmp) {
+        auto predicate = icmp->op;
+        // An i1 holds 0 or 1 here, and true is -1 when signed, so signed orders flip to unsigned ones.
+        if (icmp->type == Type::I1) {
+            switch (predicate) {
+                case IcmpInst::Op::SLT: predicate = IcmpInst::Op::UGT; break;
+                case IcmpInst::Op::SLE: predicate = IcmpInst::Op::UGE; break;
+                case IcmpInst::Op::SGT: predicate = IcmpInst::Op::ULT; break;
+                case IcmpInst::Op::SGE: predicate = IcmpInst::Op::ULE; break;
+                default: break;
+            }
+        }
+        uint32_t dst = destination(icmp), a = operand(icmp->value1, icmp->type), b = operand(icmp->value2, icmp->type);
+        emit(Op(ICMP_EQ + size_t(predicate))), emit(dst), emit(a), emit(b);
+    }
+
+    void translate(BasicBlock const*, FcmpInst* fcmp) {
+        uint32_t dst = destination(fcmp), a = operand(fcmp->value1, fcmp->type), b = operand(fcmp->value2, fcmp->type);
+        emit(Op(FCMP_FALSE + size_t(fcmp->op))), emit(dst), emit(a), emit(b);
+    }
+
+    void translate(BasicBlock const*, ConvInst* conv) {
+        uint32_t dst = destination(conv), a = operand(conv->value, conv->type1);
+        switch (conv->opcode) {
+            case Opcode::SITOFP: emit(conv->type1 == Type::I1 ? SITOFP1 : SITOFP); break;
+            case Opcode::FPTOSI: emit(FPTOSI); break;
+            default: emit(MOV); break;
+        }
+        emit(dst), emit(a);
+        if (conv->type2 == Type::I1 && conv->type1 != Type::I1) emit(MASK), emit(dst);
+    }
+
+    void translate(BasicBlock const*, AllocaInst* alloca) {
+        emit(ALLOCA), emit(destination(alloca)), emit(8);
+    }
+
+    void translate(BasicBlock const*, LoadInst* load) {
+        uint32_t dst = destination(load), from = operand(load->from, Type::PTR);
+        emit(sizeOf(load->type) == 1 ? LOAD1 : LOAD8), emit(dst), emit(from);
+    }
+
+    void translate(BasicBlock const*, StoreInst* store) {
+        uint32_t from = operand(store->from, store->type), into = operand(store->into, Type::PTR);
+        emit(sizeOf(store->type) == 1 ? STORE1 : STORE8), emit(from), emit(into);
+    }
+
+    void translate(BasicBlock const*, GEPInst* gep) {
+        uint32_t dst = destination(gep), ptr = operand(gep->ptr, Type::PTR), offset = operand(gep->offset, Type::I64);
+        emit(GEP), emit(dst), emit(ptr), emit(offset), emit(sizeOf(gep->type));
+    }
+
+    void translate(BasicBlock const*, CallInst* call) {
+        this->call(call, call->ret_type == Type::VOID ? sink : destination(call));
+    }
+
+    void call(CallInst* call, uint32_t dst) {
+        if (call->function.reg != Value::NONE) return trap("indirect call");
+        Symbol name(call->function.view());
+        std::vector<uint32_t> args;
+        for (auto&& arg : call->args) args.push_back(operand(arg.value, arg.type));
+        if (auto found = functions.find(name); found != functions.end()) {
+            if (found->second->define->params.size() != args.size()) {
+                return trap(join("wrong number of arguments to ", name.view()));
+            }
+            emit(CALL);
+            code.words.push_back({.callee = found->second});
+        } else {
+            emit(HOST);
+            emit(host(name));
+        }
+        emit(dst);
+        emit(args.size());
+        for (auto arg : args) emit(arg);
+    }
+};
+
+}
+
+Interpreter::Interpreter(std::span<const std::unique_ptr<Entity>> entities) {
+    Machine::prepare();
+    for (auto&& entity : entities) {
+        if (auto define = dynamic_cast<FunctionDefine*>(entity.get())) {
+            auto& code = codes.emplace_back(std::make_unique<Code>());
+            code->define = define;
+            functions.emplace(define->name, code.get());
+        } else if (auto global = dynamic_cast<GlobalVariable*>(entity.get())) {
+            // Left without a cell, a global the interpreter cannot initialize fails the functions using it.
+            std::unique_ptr<uint64_t[]> cell;
+            if (global->initializer) {
+                cell = std::make_unique<uint64_t[]>(GLOBAL_BYTES / sizeof(uint64_t));
+                std::memcpy(cell.get(), &global->initializer->bits, sizeOf(global->type));
+            }
+            globals.emplace(entity->name, std::move(cell));
+        }
+    }
+    auto host = [&](Symbol name) {
+        auto [found, inserted] = hostIndex.try_emplace(name, hosts.size());
+        if (inserted) {
+            hosts.push_back(nullptr);
+            hostNames.push_back(name);
+        }
+        return found->second;
+    };
+    size_t count = 0;
+    for (auto&& code : codes) {
+        Decoder{*code, *code->define, code->define->ssa, functions, globals, host, count}.decode();
+    }
+    counters.assign(count, 0);
+}
+
+Interpreter::~Interpreter() = default;
+
+void Interpreter::bind(std::string_view name, Host host) {
+    if (auto found = hostIndex.find(Symbol(name)); found != hostIndex.end()) {
+        hosts[found->second] = host;
+    }
+}
+
+void Interpreter::bindStandard() {
+    bind("@putchar", [](std::span<const uint64_t> args) { return uint64_t(std::putchar(int(args[0]))); });
+    bind("@getchar", [](std::span<const uint64_t>) { return uint64_t(int64_t(std::getchar())); });
+    bind("@print_i64", [](std::span<const uint64_t> args) {
+        std::printf("%lld\n", (long long) args[0]);
+        return uint64_t(0);
+    });
+    bind("@print_double", [](std::span<const uint64_t> args) {
+        std::printf("%.17g\n", std::bit_cast<double>(args[0]));
+        return uint64_t(0);
+    });
+    bind("@malloc", [](std::span<const uint64_t> args) { return reinterpret_cast<uint64_t>(std::malloc(args[0])); });
+    bind("@free", [](std::span<const uint64_t> args) {
+        std::free(reinterpret_cast<void*>(args[0]));
+        return uint64_t(0);
+    });
+    bind("@abort", [](std::span<const uint64_t>) -> uint64_t { throw Trap("abort called"); });
+    bind("@exit", [](std::span<const uint64_t> args) -> uint64_t { throw Exit{args.empty() ? 0 : args[0]}; });
+}
+
+uint64_t Interpreter::executed() const noexcept {
+    uint64_t total = 0;
+    std::vector<uint64_t> blocks;
+    for (auto&& code : codes) {
+        blocks.assign(code->sizes.size(), 0);
+        if (blocks.empty()) continue;
+        blocks[0] = counters[code->calls];
+        for (size_t i = 0; i < code->edges.size(); ++i) {
+            blocks[code->edges[i].second] += counters[code->calls + 1 + i];
+        }
+        for (size_t i = 0; i < blocks.size(); ++i) total += blocks[i] * code->sizes[i];
+    }
+    return total;
+}
+
+Interpreter::Result Interpreter::run(std::string_view function, std::span<const std::string_view> args) {
+    auto found = functions.find(Symbol(function));
+    if (found == functions.end()) throw Trap(join("no definition of ", function));
+    auto code = found->second;
+    auto& params = code->define->params;
+    if (params.size() != args.size()) throw Trap(join("wrong number of arguments to ", function));
+    if (registers.empty()) {
+        registers.resize(REGISTER_WORDS);
+        memory.resize(MEMORY_BYTES);
+    }
+    if (code->frameSize > registers.size()) throw Trap(join("call stack overflow in ", function));
+    uint64_t* frame = registers.data();
+    for (size_t i = 0; i < args.size(); ++i) {
+        auto value = parseConstant(params[i].type, args[i]);
+        if (!value) throw Trap(join("invalid argument ", args[i], " to ", function));
+        frame[i] = value->bits;
+    }
+    std::memcpy(frame + code->constantBase, code->constants.data(), code->constants.size() * sizeof(uint64_t));
+
+    Machine machine;
+    machine.self = this;
+    machine.counters = counters.data();
+    machine.registersEnd = registers.data() + registers.size();
+    machine.top = memory.data();
+    machine.limit = memory.data() + memory.size();
+    uint64_t before = executed();
+    auto start = std::chrono::steady_clock::now();
+    Result result;
+    try {
+        result.value = Constant::ofInt(code->returns, machine.execute(code, frame));
+    } catch (Exit& exit) {
+        result.value = Constant::ofInt(Type::I64, exit.status);
+        result.exited = true;
+    }
+    auto stop = std::chrono::steady_clock::now();
+    result.insts = executed() - before;
+    result.seconds = std::chrono::duration<double>(stop - start).count();
+    return result;
+}
+
+void Interpreter::report(FILE* out) const {
+    std::vector<uint64_t> blocks;
+    std::vector<std::pair<std::pair<uint32_t, uint32_t>, uint64_t>> edges;
+    for (auto&& code : codes) {
+        uint64_t calls = counters[code->calls];
+        if (!calls) continue;
+        auto& define = *code->define;
+        auto name = define.name.view();
+        blocks.assign(code->sizes.size(), 0);
+        blocks[0] = calls;
+        edges.clear();
+        for (size_t i = 0; i < code->edges.size(); ++i) {
+            uint64_t count = counters[code->calls + 1 + i];
+            blocks[code->edges[i].second] += count;
+            auto same = std::find_if(edges.begin(), edges.end(), [&](auto&& edge) { return edge.first == code->edges[i]; });
+            if (same != edges.end()) {
+                same->second += count;
+            } else {
+                edges.emplace_back(code->edges[i], count);
+            }
+        }
+        uint64_t insts = 0;
+        for (size_t i = 0; i < blocks.size(); ++i) insts += blocks[i] * code->sizes[i];
+        fprintf(out, "calls: %.*s: %llu\n", int(name.length()), name.data(), (unsigned long long) calls);
+        fprintf(out, "insts: %.*s: %llu\n", int(name.length()), name.data(), (unsigned long long) insts);
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            if (!blocks[i]) continue;
+            auto label = define.bbs[i]->label();
+            fprintf(out, "block: %.*s: %.*s: %llu\n", int(name.length()), name.data(),
+                    int(label.length()), label.data(), (unsigned long long) blocks[i]);
+        }
+        for (auto [edge, count] : edges) {
+            if (!count) continue;
+            auto from = define.bbs[edge.first]->label(), to = define.bbs[edge.second]->label();
+            fprintf(out, "edge: %.*s: %.*s -> %.*s: %llu\n", int(name.length()), name.data(),
+                    int(from.length()), from.data(), int(to.length()), to.data(), (unsigned long long) count);
+        }
+    }
+}
+
+}
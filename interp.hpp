@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "entity.hpp"
+#include "fold.hpp"
+
+namespace YAOPT {
+
+struct Trap : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// Executes the definitions of a module. Each function is decoded once into a flat array of direct-threaded
+// code whose operands are frame slots, so dispatch is one indirect jump per instruction. Only branches
+// bump a counter at run time; block and instruction counts are derived from the edge counts afterwards.
+// Pointers are host addresses into the interpreter's stack or global cells, as unchecked as the IR itself.
+struct Interpreter {
+    // Host implementation of a declared function; arguments and the result are raw 64-bit register values.
+    using Host = uint64_t (*)(std::span<const uint64_t> args);
+
+    struct Code;
+
+    struct Result {
+        // The returned value, or the status passed to @exit when `exited` is set.
+        Constant value;
+        bool exited = false;
+        uint64_t insts = 0;
+        double seconds = 0;
+    };
+
+    explicit Interpreter(std::span<const std::unique_ptr<Entity>> entities);
+    Interpreter(Interpreter const&) = delete;
+    ~Interpreter();
+
+    // Binds a declared function to a host implementation. Calls to declarations left unbound trap.
+    void bind(std::string_view name, Host host);
+    // Binds putchar, getchar, print_i64, print_double, malloc, free, abort and exit when they are declared.
+    // A call to exit ends the run, which reports the status as its result.
+    void bindStandard();
+
+    // Calls `function` with literal arguments parsed by the parameter types. Throws Trap on a runtime error.
+    Result run(std::string_view function, std::span<const std::string_view> args);
+
+    // Prints call, instruction, block and edge counts per function, accumulated over every run.
+    void report(FILE* out) const;
+
+private:
+    std::vector<std::unique_ptr<Code>> codes;
+    std::unordered_map<Symbol, Code*> functions;
+    std::unordered_map<Symbol, uint32_t> hostIndex;
+    std::vector<Host> hosts;
+    std::vector<Symbol> hostNames;
+    std::unordered_map<Symbol, std::unique_ptr<uint64_t[]>> globals;
+    std::vector<uint64_t> counters;
+    std::vector<uint64_t> registers;
+    std::vector<std::byte> memory;
+
+    friend struct Machine;
+
+    [[nodiscard]] uint64_t executed() const noexcept;
+};
+
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "opcode.hpp"
+
+namespace YAOPT {
+
+enum class Keyword : uint8_t {
+    NONE,
+
+    FNEG,
+    ADD,
+    FADD,
+    SUB,
+    FSUB,
+    MUL,
+    FMUL,
+    UDIV,
+    SDIV,
+    FDIV,
+    UREM,
+    SREM,
+    FREM,
+    SHL,
+    LSHR,
+    ASHR,
+    AND,
+    OR,
+    XOR,
+    ALLOCA,
+    LOAD,
+    STORE,
+    GETELEMENTPTR,
+    ICMP,
+    FCMP,
+    SITOFP,
+    FPTOSI,
+    INTTOPTR,
+    PTRTOINT,
+    CALL,
+    PHI,
+    UNREACHABLE,
+    RET,
+    BR,
+
+    VOID,
+    I1,
+    I64,
+    DOUBLE,
+    PTR,
+    LABEL,
+
+    EQ,
+    NE,
+    SLT,
+    ULT,
+    SLE,
+    ULE,
+    SGT,
+    UGT,
+    SGE,
+    UGE,
+
+    FALSE,
+    OEQ,
+    OGT,
+    OGE,
+    OLT,
+    OLE,
+    ONE,
+    ORD,
+    UEQ,
+    UNE,
+    UNO,
+    TRUE,
+
+    TO,
+    INBOUNDS,
+    DEFINE,
+    DECLARE,
+    ALIGN,
+};
+
+constexpr std::string_view KEYWORD_NAME[] = {
+    "",
+
+    "fneg",
+    "add",
+    "fadd",
+    "sub",
+    "fsub",
+    "mul",
+    "fmul",
+    "udiv",
+    "sdiv",
+    "fdiv",
+    "urem",
+    "srem",
+    "frem",
+    "shl",
+    "lshr",
+    "ashr",
+    "and",
+    "or",
+    "xor",
+    "alloca",
+    "load",
+    "store",
+    "getelementptr",
+    "icmp",
+    "fcmp",
+    "sitofp",
+    "fptosi",
+    "inttoptr",
+    "ptrtoint",
+    "call",
+    "phi",
+    "unreachable",
+    "ret",
+    "br",
+
+    "void",
+    "i1",
+    "i64",
+    "double",
+    "ptr",
+    "label",
+
+    "eq",
+    "ne",
+    "slt",
+    "ult",
+    "sle",
+    "ule",
+    "sgt",
+    "ugt",
+    "sge",
+    "uge",
+
+    "false",
+    "oeq",
+    "ogt",
+    "oge",
+    "olt",
+    "ole",
+    "one",
+    "ord",
+    "ueq",
+    "une",
+    "uno",
+    "true",
+
+    "to",
+    "inbounds",
+    "define",
+    "declare",
+    "align",
+};
+
+constexpr size_t KEYWORD_COUNT = std::size(KEYWORD_NAME);
+
+static_assert(KEYWORD_NAME[size_t(Keyword::DECLARE)] == "declare");
+static_assert(KEYWORD_NAME[size_t(Keyword::PHI)] == OPCODE_NAME[size_t(Opcode::PHI)]);
+static_assert(KEYWORD_NAME[size_t(Keyword::BR)] == OPCODE_NAME[size_t(Opcode::BR)]);
+
+[[nodiscard]] constexpr uint64_t keywordHash(std::string_view text, uint64_t seed) noexcept {
+    uint64_t hash = seed ^ text.length();
+    for (unsigned char ch : text) {
+        hash = (hash ^ ch) * 0x100000001b3;
+    }
+    return hash >> 40;
+}
+
+struct KeywordTable {
+    static constexpr size_t SIZE = 512;
+    uint64_t seed = 0;
+    std::array<Keyword, SIZE> slots{};
+
+    [[nodiscard]] constexpr Keyword find(std::string_view text) const noexcept {
+        if (text.length() < 2 || text.length() > 13) return Keyword::NONE;
+        Keyword keyword = slots[keywordHash(text, seed) % SIZE];
+        return KEYWORD_NAME[size_t(keyword)] == text ? keyword : Keyword::NONE;
+    }
+};
+
+constexpr KeywordTable KEYWORDS = [] {
+    KeywordTable table;
+    for (table.seed = 0xcbf29ce484222325; ; ++table.seed) {
+        table.slots = {};
+        bool perfect = true;
+        for (size_t i = 1; i < KEYWORD_COUNT && perfect; ++i) {
+            auto& slot = table.slots[keywordHash(KEYWORD_NAME[i], table.seed) % KeywordTable::SIZE];
+            perfect = slot == Keyword::NONE;
+            slot = Keyword(i);
+        }
+        if (perfect) return table;
+    }
+}();
+
+[[nodiscard]] constexpr Keyword keyword(std::string_view text) noexcept {
+    return KEYWORDS.find(text);
+}
+
+[[nodiscard]] constexpr bool isOpcode(Keyword keyword) noexcept {
+    return keyword >= Keyword::FNEG && keyword <= Keyword::BR;
+}
+
+[[nodiscard]] constexpr Opcode opcodeOf(Keyword keyword) noexcept {
+    return Opcode(size_t(keyword) - size_t(Keyword::FNEG));
+}
+
+}
@@ -1,5 +1,6 @@
 #include "lexer.hpp"
 #include "diagnostics.hpp"
+#include "constant.hpp"
 
 
 namespace YAOPT {
@@ -12,16 +13,16 @@ namespace YAOPT {
     return isDecimal(ch);
 }
 
-[[nodiscard]] constexpr bool isPunctuation(char ch) {
-    return ispunct(ch);
+[[nodiscard]] constexpr bool isPunctuation(char ch) noexcept {
+    return is(ch, PUNCTUATION);
 }
 
-[[nodiscard]] bool isIdentifierStart(char ch) {
-    return ch == '@' || ch == '%' || ch == '"' || ch == '_' || isalpha(ch);
+[[nodiscard]] constexpr bool isIdentifierStart(char ch) noexcept {
+    return is(ch, IDENTIFIER_START);
 }
 
-[[nodiscard]] bool isIdentifierPart(char ch) {
-    return ch == '"' || ch == '\\' || ch == '_' || isalnum(ch);
+[[nodiscard]] constexpr bool isIdentifierPart(char ch) noexcept {
+    return is(ch, IDENTIFIER_PART);
 }
 
 void LineTokenizer::raise(const char *msg) const {
@@ -29,7 +30,7 @@ void LineTokenizer::raise(const char *msg) const {
 }
 
 void LineTokenizer::tokenize() {
-    context.tokens.emplace_back();
+    tokens.open(line);
     while (remains()) {
         switch (char ch = getc()) {
             case '#':
@@ -37,8 +38,10 @@ void LineTokenizer::tokenize() {
                 break;
             case '\n':
             case '\r':
+                break;
             case '\t':
             case ' ':
+                if (remains() && is(peekc(), BLANK)) q = scanner().skipBlanks(q, r);
                 break;
             case '"':
                 addId();
@@ -47,17 +50,19 @@ void LineTokenizer::tokenize() {
                 ungetc(ch);
                 if (isIdentifierStart(ch)) {
                     addId();
-                } else if (isNumberStart(ch)) {
+                } else if (isNumberStart(ch) || (ch == '-' && q + 1 != r && isDecimal(q[1]))) {
                     addNumber();
                 } else if (isPunctuation(ch)) {
                     addPunct();
+                } else {
+                    getc();
+                    raise("unexpected character");
                 }
             }
         }
         step();
     }
-    if (context.tokens.back().empty())
-        context.tokens.pop_back();
+    tokens.close();
 }
 
 
@@ -68,21 +73,13 @@ void LineTokenizer::addId() {
     }
     do q = (remains = remains.substr(1)).data();
     while (!remains.empty() && isIdentifierPart(remains.front()));
-    add(TokenType::IDENTIFIER);
+    add(TokenType::IDENTIFIER, *p != '%' && *p != '@' ? keyword({p, q}) : Keyword::NONE);
 }
 
 void LineTokenizer::addPunct() {
-    std::string_view remains{p, r};
-    auto punct = PUNCTUATIONS.end();
-    for (auto it = PUNCTUATIONS.begin(); it != PUNCTUATIONS.end(); ++it) {
-        if (remains.starts_with(it->first)
-            && (punct == PUNCTUATIONS.end() || it->first.length() > punct->first.length())) {
-            punct = it;
-        }
-    }
-    if (punct != PUNCTUATIONS.end()) {
-        q += punct->first.length();
-        add(punct->second);
+    if (auto type = PUNCTUATIONS[static_cast<unsigned char>(*p)]; type != TokenType::INVALID) {
+        ++q;
+        add(type);
     } else {
         raise("invalid punctuation");
     }
@@ -101,6 +98,7 @@ void LineTokenizer::addNumber() {
     // scan number prefix
     TokenType base = TokenType::INTEGER;
     bool (*pred)(char) noexcept = isDecimal;
+    if (peekc() == '-') getc();
     // scan digits
     scanDigits(pred);
     bool flt = false;
@@ -127,65 +125,38 @@ void LineTokenizer::addNumber() {
     add(type);
 }
 
-void LineTokenizer::add(TokenType type) {
-    context.tokens.back().push_back(make(type));
+void LineTokenizer::add(TokenType type, Keyword keyword) {
+    auto token = make(type);
+    if (token.width > UINT16_MAX) raise("token too long");
+    token.keyword = keyword;
+    tokens.push(token);
     step();
     switch (type) {
         case TokenType::LPAREN:
         case TokenType::LBRACKET:
         case TokenType::LBRACE:
-            context.greedy.push_back(context.tokens.back().back());
-            break;
         case TokenType::RPAREN:
-            checkGreedy("(", ")", TokenType::LPAREN);
-            break;
         case TokenType::RBRACKET:
-            checkGreedy("[", "]", TokenType::LBRACKET);
-            break;
         case TokenType::RBRACE:
-            checkGreedy("{", "}", TokenType::LBRACE);
-            break;
-    }
-}
-
-void LineTokenizer::checkGreedy(const char* left, const char* right, TokenType match) {
-    if (context.greedy.empty()) {
-        Error().with(
-                ErrorMessage().error(context.tokens.back().back())
-                .text("stray").quote(right).text("without").quote(left).text("to match")
-                ).raise();
-    }
-    if (context.greedy.back().type != match) {
-        Error error;
-        error.with(ErrorMessage().error(context.tokens.back().back()).quote(right).text("mismatch"));
-        error.with(ErrorMessage().note(context.greedy.back()).quote(left).text("expected here"));
-        for (auto it = context.greedy.rbegin(); it != context.greedy.rend(); ++it) {
-            if (it->type == match) {
-                error.with(ErrorMessage().note(*it).text("nearest matching").quote(left).text("is here"));
-                break;
+            if (deferred) {
+                deferred->push_back(token);
+            } else {
+                context.bracket(token);
             }
-        }
-        if (error.messages.size() < 3) {
-            error.with(ErrorMessage().note().text("stray").quote(right).text("without").quote(left).text("to match"));
-        }
-        error.raise();
+            break;
     }
-    context.greedy.pop_back();
 }
 
-int64_t parseInt(Source& source, Token token) try {
-    std::string literal(source.of(token));
-    return std::stoll(literal, nullptr, 10);
-} catch (std::out_of_range& e) {
-    raise("int literal out of range", token);
+int64_t parseInt(Source& source, Token token) {
+    auto value = parseConstant(Type::I64, source.of(token));
+    if (!value) raise("int literal out of range", token);
+    return value->asSigned();
 }
 
-double parseFloat(Source& source, Token token) try {
-    std::string literal(source.of(token));
-    std::erase(literal, '_');
-    return std::stod(literal);
-} catch (std::out_of_range& e) {
-    raise("float literal out of range", token);
+double parseFloat(Source& source, Token token) {
+    auto value = parseConstant(Type::DOUBLE, source.of(token));
+    if (!value) raise("float literal out of range", token);
+    return value->asDouble();
 }
 
 }
\ No newline at end of file
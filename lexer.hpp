@@ -9,14 +9,23 @@ namespace YAOPT {
 
 struct LineTokenizer {
     Source& context;
+    TokenStream& tokens;
+    std::vector<Token>* deferred;
     const char *const o, *p, *q, *const r;
     const size_t line;
 
     LineTokenizer(Source& context,
                   std::string_view view):
-            context(context),
+            LineTokenizer(context, view, context.base + context.lines.size() - 1, context.tokens, nullptr) {}
+
+    LineTokenizer(Source& context,
+                  std::string_view view,
+                  size_t line,
+                  TokenStream& tokens,
+                  std::vector<Token>* deferred):
+            context(context), tokens(tokens), deferred(deferred),
             o(view.begin()), p(o), q(p), r(view.end()),
-            line(context.lines.size() - 1)
+            line(line)
             { tokenize(); }
 
     [[nodiscard]] size_t column() const noexcept {
@@ -39,8 +48,9 @@ struct LineTokenizer {
             }
         }
     }
+    // A line may end the input with nothing mapped after it, so the end reads as 0 like getc() does.
     [[nodiscard]] char peekc() const noexcept {
-        return *q;
+        return remains() ? *q : 0;
     }
     [[nodiscard]] bool remains() const noexcept {
         return q != r;
@@ -52,14 +62,13 @@ struct LineTokenizer {
         return {.line = line, .column = size_t(p - o), .width = size_t(q - p), .type = type};
     }
 
-    void add(TokenType type);
+    void add(TokenType type, Keyword keyword = Keyword::NONE);
     [[noreturn]] void raise(const char* msg) const;
     void tokenize();
     void addId();
     void addPunct();
     void scanDigits(bool pred(char) noexcept);
     void addNumber();
-    void checkGreedy(const char* left, const char* right, TokenType match);
 };
 
 int64_t parseInt(Source& source, Token token);
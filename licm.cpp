@@ -0,0 +1,270 @@
+#include "licm.hpp"
+
+#include <unordered_set>
+
+namespace YAOPT {
+
+namespace {
+
+struct Hoister {
+    FunctionDefine& define;
+    SSA& ssa;
+    // The block defining each register; NONE for parameters and immediates.
+    std::vector<uint32_t> blockOf;
+    // Per loop: whether it stores or calls, and the blocks of it that branch out of it.
+    std::vector<bool> clobbers;
+    std::vector<std::vector<uint32_t>> exiting;
+    std::unordered_set<uint32_t> names, labels;
+
+    explicit Hoister(FunctionDefine& define): define(define), ssa(define.ssa) {}
+
+    void locate() {
+        auto& info = define.loops();
+        auto& cfg = define.cfg();
+        blockOf.assign(ssa.size(), CFG::NONE);
+        for (auto bb : define.bbs) {
+            for (auto inst : bb->insts) {
+                if (inst->kind() != Inst::Kind::INTERMEDIATE) continue;
+                uint32_t number = static_cast<IntermediateInst*>(inst)->number;
+                if (number != Value::NONE) blockOf[number] = bb->index;
+            }
+        }
+        clobbers.assign(info.size(), false);
+        exiting.assign(info.size(), {});
+        for (uint32_t loop = 0; loop < info.size(); ++loop) {
+            for (auto block : info.loops[loop].blocks) {
+                for (auto inst : define.bbs[block]->insts) {
+                    if (isa<StoreInst>(inst) || isa<CallInst>(inst)) clobbers[loop] = true;
+                }
+                for (auto succ : cfg.successors(block)) {
+                    if (info.contains(loop, succ)) continue;
+                    exiting[loop].push_back(block);
+                    break;
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] bool invariant(Value const& value, uint32_t loop) {
+        if (value.reg == Value::NONE) return true;
+        uint32_t block = blockOf[ssa.find(value.reg)];
+        return block == CFG::NONE || !define.loops().contains(loop, block);
+    }
+
+    // Registers by their current leader, anything else as gvn numbers it.
+    [[nodiscard]] uint64_t keyOf(Value const& value) {
+        if (value.reg == Value::NONE) return value.immediateKey();
+        uint32_t reg = ssa.find(value.reg);
+        return ssa.slots[reg].immediate ? ssa.slots[reg].immediateKey() : reg;
+    }
+
+    [[nodiscard]] uint32_t constantOf(Value const& value) {
+        if (value.reg == Value::NONE) return value.constant;
+        auto& slot = ssa.slots[ssa.find(value.reg)];
+        return slot.immediate ? slot.constant : Value::NONE;
+    }
+
+    // Integer division and remainder trap on a zero divisor, the signed ones also on INT64_MIN by -1.
+    [[nodiscard]] bool speculatable(BinaryOpInst* binary) {
+        switch (binary->opcode) {
+            case Opcode::UDIV:
+            case Opcode::UREM:
+            case Opcode::SDIV:
+            case Opcode::SREM: {
+                uint32_t divisor = constantOf(binary->value2);
+                if (divisor == Value::NONE) return false;
+                auto bits = ConstantPool::at(divisor).value.bits;
+                bool sign = binary->opcode == Opcode::SDIV || binary->opcode == Opcode::SREM;
+                return bits && !(sign && binary->type == Type::I64 && int64_t(bits) == -1);
+            }
+            default:
+                return true;
+        }
+    }
+
+    // Whether `block` runs before the loop can be left, on every trip through it.
+    [[nodiscard]] bool guaranteed(uint32_t loop, uint32_t block) {
+        auto& tree = define.dominators();
+        if (exiting[loop].empty()) return false;
+        for (auto exit : exiting[loop]) {
+            if (!tree.dominates(block, exit)) return false;
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool hoistable(Inst* inst, uint32_t loop, uint32_t block) {
+        if (inst->kind() != Inst::Kind::INTERMEDIATE || static_cast<IntermediateInst*>(inst)->number == Value::NONE) {
+            return false;
+        }
+        if (auto binary = dyn_cast<BinaryOpInst>(inst)) {
+            if (!speculatable(binary)) return false;
+        } else if (isa<LoadInst>(inst)) {
+            if (clobbers[loop] || !guaranteed(loop, block)) return false;
+        } else if (!isa<CmpInst>(inst) && !isa<ConvInst>(inst) && !isa<GEPInst>(inst)) {
+            return false;
+        }
+        bool ready = true;
+        inst->forEachOperand([&](Value& value) { ready = ready && invariant(value, loop); });
+        return ready;
+    }
+
+    // The block outside the loop that alone enters the header and branches nowhere else, if there is one.
+    [[nodiscard]] BasicBlock* preheader(uint32_t loop) {
+        auto& info = define.loops();
+        auto& cfg = define.cfg();
+        uint32_t header = info.loops[loop].header, found = CFG::NONE;
+        for (auto pred : cfg.predecessors(header)) {
+            if (info.contains(loop, pred)) continue;
+            if (found != CFG::NONE) return nullptr;
+            found = pred;
+        }
+        if (found == CFG::NONE || cfg.successors(found).size() != 1) return nullptr;
+        return define.bbs[found];
+    }
+
+    [[nodiscard]] Symbol fresh(std::unordered_set<uint32_t>& taken, std::string_view base) {
+        auto name = std::string(base);
+        for (size_t i = 1; taken.contains(Symbol(name, define.symbols).id); ++i) {
+            name = join(base, "_", std::to_string(i));
+        }
+        Symbol symbol(name, define.symbols);
+        taken.insert(symbol.id);
+        return symbol;
+    }
+
+    // Puts a new block in front of the header of `loop` and moves every edge entering the loop onto it.
+    // Phi entries for those edges move along; when they disagree, they are merged by a phi in the new block.
+    BasicBlock* insertPreheader(uint32_t loop) {
+        auto& info = define.loops();
+        auto& cfg = define.cfg();
+        if (labels.empty()) {
+            for (auto&& slot : ssa.slots) {
+                if (!slot.immediate) names.insert(slot.name.id);
+            }
+            for (auto bb : define.bbs) labels.insert(bb->labelInst->label.id);
+        }
+        auto header = define.bbs[info.loops[loop].header];
+        auto bb = define.arena.make<BasicBlock>();
+        bb->labelInst = define.arena.make<LabelInst>(fresh(labels, join(header->label(), "_preheader")));
+        auto jump = define.arena.make<BrLabelInst>();
+        jump->label = header->labelInst->label;
+        jump->target = header;
+        bb->terminatorInst = jump;
+        bb->insts.push_back(bb->labelInst);
+        bb->insts.push_back(jump);
+
+        std::vector<bool> outside(define.bbs.size());
+        for (auto pred : cfg.predecessors(header->index)) {
+            if (info.contains(loop, pred)) continue;
+            outside[pred] = true;
+            define.bbs[pred]->terminatorInst->forEachTarget([&](Symbol& label, BasicBlock*& target) {
+                if (target != header) return;
+                label = bb->labelInst->label;
+                target = bb;
+            });
+        }
+        std::vector<PhiInst::Incoming> incoming;
+        for (auto inst : header->insts) {
+            if (inst == header->labelInst) continue;
+            auto phi = dyn_cast<PhiInst>(inst);
+            if (!phi) break;
+            PhiInst::Incoming* first = nullptr;
+            bool same = true;
+            for (auto&& in : phi->incoming) {
+                if (!outside[in.block->index]) continue;
+                if (!first) first = &in;
+                same = same && keyOf(in.value) == keyOf(first->value);
+            }
+            if (!first) continue;
+            if (!same) {
+                incoming.clear();
+                for (auto&& in : phi->incoming) {
+                    if (outside[in.block->index]) incoming.push_back({{}, in.label, in.block});
+                }
+                auto merge = define.arena.make<PhiInst>(phi->type, define.arena.array<PhiInst::Incoming>(incoming));
+                size_t i = 0;
+                for (auto&& in : phi->incoming) {
+                    if (outside[in.block->index]) ssa.move(in.value, merge->incoming[i++].value, merge);
+                }
+                merge->receiver = fresh(names, join(phi->receiver.view(), "_", bb->label()));
+                merge->number = ssa.define(merge->receiver, merge);
+                bb->insts.insert(jump, merge);
+                first->value = Value(merge->receiver);
+                ssa.use(first->value, phi, merge->number);
+            }
+            first->label = bb->labelInst->label;
+            first->block = bb;
+            prune(ssa, phi, [&](PhiInst::Incoming const& in) { return &in == first || !outside[in.block->index]; });
+        }
+        return bb;
+    }
+
+    PassResult run() {
+        locate();
+        auto& info = define.loops();
+        std::vector<BasicBlock*> preheaders(define.bbs.size());
+        size_t inserted = 0;
+        for (uint32_t loop = 0; loop < info.size(); ++loop) {
+            if (preheader(loop)) continue;
+            bool wanted = false;
+            for (auto block : info.loops[loop].blocks) {
+                for (auto inst : define.bbs[block]->insts) {
+                    if (hoistable(inst, loop, block)) {
+                        wanted = true;
+                        break;
+                    }
+                }
+                if (wanted) break;
+            }
+            if (!wanted) continue;
+            preheaders[info.loops[loop].header] = insertPreheader(loop);
+            ++inserted;
+        }
+        if (inserted) {
+            std::vector<BasicBlock*> bbs;
+            bbs.reserve(define.bbs.size() + inserted);
+            for (auto bb : define.bbs) {
+                if (auto pre = preheaders[bb->index]) bbs.push_back(pre);
+                bbs.push_back(bb);
+            }
+            for (uint32_t i = 0; i < bbs.size(); ++i) bbs[i]->index = i;
+            define.bbs = std::move(bbs);
+            define.invalidate();
+            locate();
+        }
+
+        // An instruction moving out of several nested loops counts once.
+        std::vector<bool> moved(ssa.size());
+        size_t hoisted = 0;
+        for (uint32_t loop = 0; loop < define.loops().size(); ++loop) {
+            auto pre = preheader(loop);
+            if (!pre) continue;
+            for (auto block : define.loops().loops[loop].blocks) {
+                auto bb = define.bbs[block];
+                for (auto it = bb->insts.begin(); it != bb->insts.end();) {
+                    auto inst = *it;
+                    ++it;
+                    if (!hoistable(inst, loop, block)) continue;
+                    bb->insts.erase(inst);
+                    pre->insts.insert(pre->terminatorInst, inst);
+                    uint32_t number = static_cast<IntermediateInst*>(inst)->number;
+                    blockOf[number] = pre->index;
+                    if (!moved[number]) moved[number] = true, ++hoisted;
+                }
+            }
+        }
+        if (inserted) return {hoisted, Changed::CONTROL};
+        return {hoisted, hoisted ? Changed::VALUES : Changed::NOTHING};
+    }
+};
+
+}
+
+PassResult licm(FunctionDefine& define) {
+    if (define.bbs.empty()) return {};
+    auto result = Hoister(define).run();
+    if (result.changes) define.ssa.flush();
+    return result;
+}
+
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "entity.hpp"
+
+namespace YAOPT {
+
+// Loop-invariant code motion: binary ops, compares, casts and getelementptr whose operands are all defined
+// outside a loop move to its preheader, innermost loops first, so a value invariant in an outer loop too
+// keeps moving outwards. Division and remainder move only by a constant divisor that cannot trap. A load
+// moves when nothing in the loop stores or calls and its block dominates every way out of the loop.
+// A loop with something to hoist and no preheader gets one. Reports the number of hoisted instructions.
+PassResult licm(FunctionDefine& define);
+
+}
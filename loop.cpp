@@ -0,0 +1,65 @@
+#include "loop.hpp"
+
+#include <algorithm>
+#include <ranges>
+
+namespace YAOPT {
+
+LoopInfo::LoopInfo(CFG const& cfg, DomTree const& tree): innermost(cfg.size(), CFG::NONE) {
+    // A header dominates every block of its loop, so a postorder walk meets inner headers first; when the
+    // backward walk from the latches runs into a block already claimed, it jumps to the header of the
+    // outermost loop found so far around that block, which becomes a child.
+    std::vector<uint32_t> work;
+    for (auto header : cfg.postorder()) {
+        for (auto pred : cfg.predecessors(header)) {
+            if (cfg.reachable(pred) && tree.dominates(header, pred)) work.push_back(pred);
+        }
+        if (work.empty()) continue;
+        uint32_t loop = loops.size();
+        loops.push_back({.header = header, .latches = work});
+        std::ranges::sort(loops.back().latches);
+        loops.back().latches.erase(std::ranges::unique(loops.back().latches).begin(), loops.back().latches.end());
+        while (!work.empty()) {
+            uint32_t block = work.back();
+            work.pop_back();
+            if (innermost[block] == CFG::NONE) {
+                innermost[block] = loop;
+                if (block == header) continue;
+                for (auto pred : cfg.predecessors(block)) {
+                    if (cfg.reachable(pred)) work.push_back(pred);
+                }
+                continue;
+            }
+            uint32_t outer = innermost[block];
+            while (loops[outer].parent != CFG::NONE) outer = loops[outer].parent;
+            if (outer == loop) continue;
+            loops[outer].parent = loop;
+            for (auto pred : cfg.predecessors(loops[outer].header)) {
+                if (cfg.reachable(pred)) work.push_back(pred);
+            }
+        }
+    }
+
+    for (auto& loop : std::views::reverse(loops)) {
+        if (loop.parent == CFG::NONE) continue;
+        loop.depth = loops[loop.parent].depth + 1;
+        loops[loop.parent].children.push_back(&loop - loops.data());
+    }
+    for (auto block : cfg.rpo) {
+        for (uint32_t loop = innermost[block]; loop != CFG::NONE; loop = loops[loop].parent) {
+            loops[loop].blocks.push_back(block);
+        }
+    }
+    for (uint32_t loop = 0; loop < loops.size(); ++loop) {
+        auto& exits = loops[loop].exits;
+        for (auto block : loops[loop].blocks) {
+            for (auto succ : cfg.successors(block)) {
+                if (!contains(loop, succ)) exits.push_back(succ);
+            }
+        }
+        std::ranges::sort(exits);
+        exits.erase(std::ranges::unique(exits).begin(), exits.end());
+    }
+}
+
+}
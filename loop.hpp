@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "cfg.hpp"
+#include "dom.hpp"
+
+namespace YAOPT {
+
+// The natural loops of a CFG, found from the edges whose target dominates their source. All back edges to
+// one header make up one loop. Loops are numbered inner before outer, so a loop's parent comes after it.
+struct LoopInfo {
+    struct Loop {
+        uint32_t header;
+        uint32_t parent = CFG::NONE;
+        uint32_t depth = 1;
+        std::vector<uint32_t> latches{};
+        // Every block of the loop, nested loops included, in reverse postorder; the header comes first.
+        std::vector<uint32_t> blocks{};
+        // The blocks outside the loop that a block of the loop branches to.
+        std::vector<uint32_t> exits{};
+        std::vector<uint32_t> children{};
+    };
+
+    std::vector<Loop> loops;
+    // The innermost loop of each block, or NONE outside of every loop.
+    std::vector<uint32_t> innermost;
+
+    LoopInfo(CFG const& cfg, DomTree const& tree);
+
+    [[nodiscard]] size_t size() const noexcept {
+        return loops.size();
+    }
+    [[nodiscard]] bool contains(uint32_t loop, uint32_t block) const noexcept {
+        uint32_t inner = innermost[block];
+        while (inner != CFG::NONE && loops[inner].depth > loops[loop].depth) inner = loops[inner].parent;
+        return inner == loop;
+    }
+};
+
+}
@@ -1,30 +1,216 @@
 #include "parser.hpp"
 #include "diagnostics.hpp"
+#include "pass.hpp"
+#include "cache.hpp"
+#include "interp.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <optional>
+
+[[noreturn]] void usage(const char* problem) {
+    YAOPT::Error error;
+    error.with(YAOPT::ErrorMessage().fatal().text(problem));
+    error.with(YAOPT::ErrorMessage().usage().text("YAOPT [-j[<threads>]] [-live] [-stats] [-passes=<pass>,...] [-cache[=<dir>]] [-run=<function>[,<arg>...]] [-stream] [-o <output>] <input>"));
+    error.report(nullptr, true);
+    std::exit(10);
+}
 
 int main(int argc, const char* argv[]) {
     YAOPT::forceUTF8();
-    const int argi = 2;
-    if (argc < argi) {
-        YAOPT::Error error;
-        error.with(YAOPT::ErrorMessage().fatal().text("too few arguments, input file expected"));
-        error.with(YAOPT::ErrorMessage().usage().text("YAOPT <input>"));
-        error.report(nullptr, true);
-        std::exit(10);
-    }
-    const char* input_file = argv[1];
-    YAOPT::Parser parser(YAOPT::readText(input_file));
+    const char* input_file = nullptr;
+    size_t threads = 1;
+    bool live = false;
+    bool stats = false;
+    bool streaming = false;
+    const char* cache_dir = nullptr;
+    const char* output = "out.md";
+    std::vector<std::string_view> run;
+    YAOPT::ModulePassManager passes;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg.starts_with("-j")) {
+            arg.remove_prefix(2);
+            if (arg.empty()) {
+                threads = YAOPT::defaultThreads();
+            } else if (auto [ptr, ec] = std::from_chars(arg.begin(), arg.end(), threads);
+                    ec != std::errc{} || ptr != arg.end() || threads == 0) {
+                usage("invalid thread count");
+            }
+        } else if (arg.starts_with("-passes=")) {
+            arg.remove_prefix(8);
+            if (!YAOPT::parsePipeline(arg, passes.functions).empty()) usage("unknown pass");
+        } else if (arg == "-o") {
+            if (++i == argc) usage("output file expected after -o");
+            output = argv[i];
+        } else if (arg == "-live") {
+            live = true;
+        } else if (arg == "-stats") {
+            stats = true;
+        } else if (arg == "-stream") {
+            streaming = true;
+        } else if (arg == "-cache") {
+            cache_dir = ".yaopt-cache";
+        } else if (arg.starts_with("-cache=") && arg.length() > 7) {
+            cache_dir = argv[i] + 7;
+        } else if (arg.starts_with("-run=") && arg.length() > 5) {
+            arg.remove_prefix(5);
+            run.clear();
+            for (size_t comma; (comma = arg.find(',')) != arg.npos; arg.remove_prefix(comma + 1)) {
+                run.push_back(arg.substr(0, comma));
+            }
+            run.push_back(arg);
+        } else if (arg.starts_with("-")) {
+            usage("unknown option");
+        } else if (input_file) {
+            usage("too many arguments");
+        } else {
+            input_file = argv[i];
+        }
+    }
+    if (!input_file) {
+        usage("too few arguments, input file expected");
+    }
+    if (streaming && !run.empty()) {
+        usage("-run needs the whole module and cannot be combined with -stream");
+    }
+    YAOPT::ThreadPool pool(threads);
+    YAOPT::Parser parser(YAOPT::Input::map(input_file));
+    std::optional<YAOPT::ResultCache> cache;
+    std::vector<YAOPT::ResultCache::Key> keys;
+    // Cached functions are not parsed, so there would be nothing to execute.
+    if (cache_dir && run.empty()) {
+        std::string config = live ? "live" : "";
+        for (auto pass : passes.functions.passes) config += YAOPT::join(",", pass->name);
+        cache.emplace(cache_dir, config);
+    }
+    auto write = [&](auto&& body) {
+        FILE* out = std::string_view(output) == "-" ? stdout : YAOPT::open(output, "w");
+        {
+            YAOPT::FileSink sink(out, pool.size() > 1);
+            sink.print("# CFG of ", input_file, "\n");
+            body(sink);
+            if (!sink.flush()) {
+                YAOPT::Error error;
+                error.with(YAOPT::ErrorMessage().fatal().text("failed to write output file: ").text(output));
+                error.report(nullptr, true);
+                std::exit(20);
+            }
+        }
+        if (out != stdout) fclose(out);
+    };
+    if (streaming) {
+        // One entity at a time: parse, optimize, write, then free it. Only declarations and globals stay.
+        std::vector<size_t> changes(passes.functions.passes.size());
+        write([&](YAOPT::Sink& sink) {
+            try {
+                parser.stream([&](YAOPT::Parser::Span span) {
+                    bool define = parser.source.tokens[span.begin].front().keyword == YAOPT::Keyword::DEFINE;
+                    YAOPT::ResultCache::Key key{};
+                    if (define && cache) {
+                        key = cache->key(parser.source, span.begin, span.end);
+                        if (auto text = cache->load(key)) {
+                            sink.put(*text);
+                            return;
+                        }
+                    }
+                    auto entity = parser.parseEntity(span);
+                    if (!define) {
+                        entity->serialize(sink);
+                        parser.entities.push_back(std::move(entity));
+                        return;
+                    }
+                    auto& function = static_cast<YAOPT::FunctionDefine&>(*entity);
+                    function.showLiveness = live;
+                    std::fill(changes.begin(), changes.end(), 0);
+                    passes.functions.run(function, changes);
+                    if (cache) {
+                        YAOPT::StringSink part;
+                        function.serialize(part);
+                        auto text = part.take();
+                        cache->store(key, text);
+                        sink.put(text);
+                    } else {
+                        function.serialize(sink);
+                    }
+                    if (stats) passes.functions.report(function, changes, stderr);
+                });
+            } catch (YAOPT::Error& error) {
+                error.report(&parser.source, true);
+                std::exit(20);
+            }
+        });
+        if (cache) {
+            fprintf(stderr, "cache: %zu hits, %zu misses\n", cache->hits.load(), cache->misses.load());
+        }
+        return 0;
+    }
     try {
-        parser.tokenize();
-        parser.parse();
+        parser.tokenize(pool);
+        if (cache) {
+            auto spans = parser.scan();
+            keys.resize(spans.size());
+            parser.parse(pool, spans, [&](size_t i, YAOPT::Parser::Span span) -> std::unique_ptr<YAOPT::Entity> {
+                if (parser.source.tokens[span.begin].front().keyword != YAOPT::Keyword::DEFINE) return nullptr;
+                keys[i] = cache->key(parser.source, span.begin, span.end);
+                if (auto text = cache->load(keys[i])) return std::make_unique<YAOPT::CachedEntity>(std::move(*text));
+                return nullptr;
+            });
+        } else {
+            parser.parse(pool);
+        }
     } catch (YAOPT::Error& error) {
         error.report(&parser.source, true);
         std::exit(20);
     }
-    std::string buf;
-    for (auto&& entity : parser.entities) {
-        buf += entity->serialize();
+    passes.run(parser.entities, pool);
+    if (!run.empty()) {
+        try {
+            YAOPT::Interpreter interpreter(parser.entities);
+            interpreter.bindStandard();
+            auto result = interpreter.run(run[0], std::span(run).subspan(1));
+            auto value = result.value.type == YAOPT::Type::VOID ? std::string("void") : result.value.text();
+            if (value.empty()) value = std::to_string(result.value.bits);
+            fprintf(stderr, "run: %.*s: %s %s, %llu instructions in %.6f s\n", int(run[0].length()), run[0].data(),
+                    result.exited ? "exited with" : "returned", value.c_str(), (unsigned long long) result.insts, result.seconds);
+            if (stats) interpreter.report(stderr);
+        } catch (YAOPT::Trap& trap) {
+            YAOPT::Error error;
+            error.with(YAOPT::ErrorMessage().fatal().text(trap.what()));
+            error.report(nullptr, true);
+            std::exit(30);
+        }
+    }
+    write([&](YAOPT::Sink& sink) {
+        if (pool.size() == 1 && !cache) {
+            for (auto&& entity : parser.entities) {
+                if (auto define = dynamic_cast<YAOPT::FunctionDefine*>(entity.get())) define->showLiveness = live;
+                entity->serialize(sink);
+            }
+        } else {
+            // A batch of entities is serialized in parallel and written in order before the next one starts,
+            // so only one batch of text is held next to the IR.
+            size_t batch = pool.size() * 16;
+            std::vector<std::string> parts;
+            for (size_t begin = 0; begin < parser.entities.size(); begin += batch) {
+                parts.assign(std::min(batch, parser.entities.size() - begin), {});
+                pool.parallelFor(parts.size(), [&](size_t j) {
+                    size_t i = begin + j;
+                    auto define = dynamic_cast<YAOPT::FunctionDefine*>(parser.entities[i].get());
+                    if (define) define->showLiveness = live;
+                    YAOPT::StringSink part;
+                    parser.entities[i]->serialize(part);
+                    parts[j] = part.take();
+                    if (define && cache) cache->store(keys[i], parts[j]);
+                });
+                for (auto&& part : parts) sink.put(part);
+            }
+        }
+    });
+    if (stats) {
+        passes.report(parser.entities, stderr);
+    }
+    if (cache) {
+        fprintf(stderr, "cache: %zu hits, %zu misses\n", cache->hits.load(), cache->misses.load());
     }
-    FILE* out = YAOPT::open("out.md", "w");
-    fprintf(out, "# CFG of %s\n", input_file);
-    fprintf(out, "%s", buf.data());
 }
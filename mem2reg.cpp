@@ -0,0 +1,227 @@
+#include "mem2reg.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace YAOPT {
+
+namespace {
+
+struct Candidate {
+    AllocaInst* alloca;
+    BasicBlock* block;
+    std::vector<uint32_t> defs{}, liveIn{};
+};
+
+struct Promoter {
+    FunctionDefine& define;
+    SSA& ssa;
+    CFG const& cfg;
+    DomTree const& tree;
+    std::vector<Candidate> candidates;
+    std::unordered_map<uint32_t, uint32_t> index;
+    std::vector<std::vector<std::pair<uint32_t, PhiInst*>>> phis;
+    std::unordered_set<uint32_t> names;
+
+    explicit Promoter(FunctionDefine& define):
+            define(define), ssa(define.ssa), cfg(define.cfg()), tree(define.dominators()), phis(cfg.size()) {}
+
+    [[nodiscard]] uint32_t candidateOf(Value const& pointer) {
+        if (pointer.reg == Value::NONE) return Value::NONE;
+        auto found = index.find(ssa.find(pointer.reg));
+        return found == index.end() ? Value::NONE : found->second;
+    }
+
+    void collect() {
+        for (auto bb : define.bbs) {
+            for (auto inst : bb->insts) {
+                auto alloca = dyn_cast<AllocaInst>(inst);
+                if (!alloca || alloca->number == Value::NONE) continue;
+                bool promotable = true;
+                ssa.forEachUse(alloca->number, [&](SSA::Use const& use) {
+                    if (auto load = dyn_cast<LoadInst>(use.user)) {
+                        promotable &= use.value == &load->from && load->type == alloca->type;
+                    } else if (auto store = dyn_cast<StoreInst>(use.user)) {
+                        promotable &= use.value == &store->into && store->type == alloca->type;
+                    } else {
+                        promotable = false;
+                    }
+                });
+                if (!promotable) continue;
+                index.emplace(ssa.find(alloca->number), candidates.size());
+                candidates.push_back({alloca, bb});
+            }
+        }
+    }
+
+    // Records the blocks that store to each candidate and the blocks that load it before any store there,
+    // then widens the latter to every block the value is live into.
+    void scan() {
+        std::vector<uint32_t> stored(candidates.size(), CFG::NONE), loaded(candidates.size(), CFG::NONE);
+        for (auto bb : define.bbs) {
+            for (auto inst : bb->insts) {
+                if (auto load = dyn_cast<LoadInst>(inst)) {
+                    uint32_t c = candidateOf(load->from);
+                    if (c == Value::NONE || stored[c] == bb->index || loaded[c] == bb->index) continue;
+                    loaded[c] = bb->index;
+                    candidates[c].liveIn.push_back(bb->index);
+                } else if (auto store = dyn_cast<StoreInst>(inst)) {
+                    uint32_t c = candidateOf(store->into);
+                    if (c == Value::NONE || stored[c] == bb->index) continue;
+                    stored[c] = bb->index;
+                    candidates[c].defs.push_back(bb->index);
+                }
+            }
+        }
+        std::vector<uint32_t> defines(cfg.size(), CFG::NONE), live(cfg.size(), CFG::NONE);
+        for (uint32_t c = 0; c < candidates.size(); ++c) {
+            auto& candidate = candidates[c];
+            for (auto block : candidate.defs) defines[block] = c;
+            auto work = candidate.liveIn;
+            for (auto block : work) live[block] = c;
+            while (!work.empty()) {
+                uint32_t block = work.back();
+                work.pop_back();
+                for (auto pred : cfg.predecessors(block)) {
+                    if (live[pred] == c || defines[pred] == c) continue;
+                    live[pred] = c;
+                    candidate.liveIn.push_back(pred);
+                    work.push_back(pred);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] Symbol fresh(std::string_view base, std::string_view label) {
+        if (names.empty()) {
+            for (auto&& slot : ssa.slots) {
+                if (!slot.immediate) names.insert(slot.name.id);
+            }
+        }
+        auto name = join(base, "_", label);
+        for (size_t i = 1; names.contains(Symbol(name, define.symbols).id); ++i) {
+            name = join(base, "_", label, "_", std::to_string(i));
+        }
+        Symbol symbol(name, define.symbols);
+        names.insert(symbol.id);
+        return symbol;
+    }
+
+    void place(DomFrontier const& frontier) {
+        std::vector<uint32_t> placed(cfg.size(), CFG::NONE), live(cfg.size(), CFG::NONE);
+        std::vector<PhiInst::Incoming> incoming;
+        Value undef("undef");
+        for (uint32_t c = 0; c < candidates.size(); ++c) {
+            auto& candidate = candidates[c];
+            for (auto block : candidate.liveIn) live[block] = c;
+            auto work = candidate.defs;
+            while (!work.empty()) {
+                uint32_t block = work.back();
+                work.pop_back();
+                for (auto target : frontier.of(block)) {
+                    if (placed[target] == c || live[target] != c) continue;
+                    placed[target] = c;
+                    auto bb = define.bbs[target];
+                    incoming.clear();
+                    for (auto pred : cfg.predecessors(target)) {
+                        incoming.push_back({undef, define.bbs[pred]->labelInst->label, define.bbs[pred]});
+                    }
+                    auto phi = define.arena.make<PhiInst>(candidate.alloca->type, define.arena.array<PhiInst::Incoming>(incoming));
+                    phi->receiver = fresh(candidate.alloca->receiver.view(), bb->label());
+                    phi->number = ssa.define(phi->receiver, phi);
+                    bb->insts.insert(bb->labelInst->next, phi);
+                    phis[target].emplace_back(c, phi);
+                    work.push_back(target);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] uint32_t slotOf(Value const& value) {
+        return value.reg != Value::NONE ? ssa.find(value.reg) : ssa.immediate(value);
+    }
+
+    // Rewrites the loads and stores of one block against the current value of each candidate.
+    void rewrite(BasicBlock* bb, std::vector<uint32_t>& current, std::vector<std::pair<uint32_t, uint32_t>>* log) {
+        for (auto [c, phi] : phis[bb->index]) {
+            if (log) log->emplace_back(c, current[c]);
+            current[c] = phi->number;
+        }
+        for (auto it = bb->insts.begin(); it != bb->insts.end();) {
+            auto inst = *it;
+            ++it;
+            if (auto load = dyn_cast<LoadInst>(inst)) {
+                uint32_t c = candidateOf(load->from);
+                if (c == Value::NONE) continue;
+                if (load->number != Value::NONE) ssa.replaceAllUsesWith(load->number, current[c]);
+            } else if (auto store = dyn_cast<StoreInst>(inst)) {
+                uint32_t c = candidateOf(store->into);
+                if (c == Value::NONE) continue;
+                if (log) log->emplace_back(c, current[c]);
+                current[c] = slotOf(store->from);
+            } else {
+                continue;
+            }
+            ssa.drop(inst);
+            bb->insts.erase(inst);
+        }
+    }
+
+    void rename() {
+        uint32_t undef = ssa.immediate(Value("undef"));
+        std::vector<uint32_t> current(candidates.size(), undef);
+        std::vector<std::pair<uint32_t, uint32_t>> log;
+        std::vector<std::tuple<uint32_t, uint32_t, size_t>> stack;
+        auto enter = [&](uint32_t block) {
+            stack.emplace_back(block, 0, log.size());
+            rewrite(define.bbs[block], current, &log);
+            for (auto succ : cfg.successors(block)) {
+                auto preds = cfg.predecessors(succ);
+                for (auto [c, phi] : phis[succ]) {
+                    for (size_t i = 0; i < preds.size(); ++i) {
+                        auto& value = phi->incoming[i].value;
+                        if (preds[i] == block && value.reg == Value::NONE) ssa.use(value, phi, current[c]);
+                    }
+                }
+            }
+        };
+        enter(tree.root);
+        while (!stack.empty()) {
+            auto& [block, next, mark] = stack.back();
+            auto children = tree.children(block);
+            if (next != children.size()) {
+                enter(children[next++]);
+                continue;
+            }
+            for (size_t i = log.size(); i != mark; --i) {
+                current[log[i - 1].first] = log[i - 1].second;
+            }
+            log.resize(mark);
+            stack.pop_back();
+        }
+        for (auto bb : define.bbs) {
+            if (tree.reachable(bb->index)) continue;
+            std::fill(current.begin(), current.end(), undef);
+            rewrite(bb, current, nullptr);
+        }
+        for (auto&& candidate : candidates) {
+            candidate.block->insts.erase(candidate.alloca);
+        }
+    }
+};
+
+}
+
+PassResult mem2reg(FunctionDefine& define) {
+    if (define.bbs.empty()) return {};
+    Promoter promoter(define);
+    promoter.collect();
+    if (promoter.candidates.empty()) return {};
+    promoter.scan();
+    promoter.place(DomFrontier(promoter.cfg, promoter.tree));
+    promoter.rename();
+    define.ssa.flush();
+    return {promoter.candidates.size(), Changed::VALUES};
+}
+
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "entity.hpp"
+
+namespace YAOPT {
+
+// Promotes allocas that are only loaded from and stored to into SSA values, placing phis on the iterated
+// dominance frontier of the stores where the value is live. Reports the number of promoted allocas.
+PassResult mem2reg(FunctionDefine& define);
+
+}
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <unordered_map>
 #include <string_view>
 
 enum class Opcode {
@@ -34,9 +33,13 @@ enum class Opcode {
     INTTOPTR,
     PTRTOINT,
     CALL,
+    PHI,
     UNREACHABLE,
     RET,
     BR,
+    // Tags of instructions that have no keyword of their own.
+    BR_COND,
+    LABEL,
 };
 
 constexpr std::string_view OPCODE_NAME[] = {
@@ -70,43 +73,10 @@ constexpr std::string_view OPCODE_NAME[] = {
     "inttoptr",
     "ptrtoint",
     "call",
+    "phi",
     "unreachable",
     "ret",
     "br",
+    "br",
+    "label",
 };
-
-inline const std::unordered_map<std::string_view, Opcode> OPCODES {
-    {"fneg", Opcode::FNEG},
-    {"add", Opcode::ADD},
-    {"fadd", Opcode::FADD},
-    {"sub", Opcode::SUB},
-    {"fsub", Opcode::FSUB},
-    {"mul", Opcode::MUL},
-    {"fmul", Opcode::FMUL},
-    {"udiv", Opcode::UDIV},
-    {"sdiv", Opcode::SDIV},
-    {"fdiv", Opcode::FDIV},
-    {"urem", Opcode::UREM},
-    {"srem", Opcode::SREM},
-    {"frem", Opcode::FREM},
-    {"shl", Opcode::SHL},
-    {"lshr", Opcode::LSHR},
-    {"ashr", Opcode::ASHR},
-    {"and", Opcode::AND},
-    {"or", Opcode::OR},
-    {"xor", Opcode::XOR},
-    {"alloca", Opcode::ALLOCA},
-    {"load", Opcode::LOAD},
-    {"store", Opcode::STORE},
-    {"getelementptr", Opcode::GETELEMENTPTR},
-    {"icmp", Opcode::ICMP},
-    {"fcmp", Opcode::FCMP},
-    {"sitofp", Opcode::SITOFP},
-    {"fptosi", Opcode::FPTOSI},
-    {"inttoptr", Opcode::INTTOPTR},
-    {"ptrtoint", Opcode::PTRTOINT},
-    {"call", Opcode::CALL},
-    {"unreachable", Opcode::UNREACHABLE},
-    {"ret", Opcode::RET},
-    {"br", Opcode::BR},
-};
\ No newline at end of file
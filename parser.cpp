@@ -1,122 +1,234 @@
 #include "parser.hpp"
 
+#include <bit>
 #include <cassert>
+#include <charconv>
+#include <exception>
 #include <optional>
 
 namespace YAOPT {
 
+std::vector<Parser::Span> Parser::scan() {
+    std::vector<Span> spans;
+    auto& tokens = source.tokens;
+    for (size_t i = 0; i < tokens.size(); ) {
+        auto head = tokens[i].front();
+        if (head.keyword == Keyword::DEFINE) {
+            auto begin = i++;
+            while (i < tokens.size() && tokens.types[tokens.starts[i]] != TokenType::RBRACE) ++i;
+            if (i < tokens.size()) ++i;
+            spans.push_back({begin, i});
+        } else if (head.keyword == Keyword::DECLARE || source.of(head).starts_with("@")) {
+            spans.push_back({i, i + 1});
+            ++i;
+        } else {
+            ++i;
+        }
+    }
+    return spans;
+}
+
 void Parser::parse() {
-    _it = source.tokens.begin();
-    while (remains()) {
-        assert(!peekLine().empty());
-        auto id = source.of(peekLine().front());
-        if (id == "define") {
-            parseDefine();
-        } else if (id == "declare") {
-            parseDeclare();
-        } else if (id.starts_with("@")) {
-            parseGlobalVariable();
+    for (auto span : scan()) {
+        entities.push_back(parseEntity(span));
+    }
+}
+
+void Parser::parse(ThreadPool& pool) {
+    parse(pool, scan(), [](size_t, Span) { return std::unique_ptr<Entity>(); });
+}
+
+void Parser::parse(ThreadPool& pool, std::span<const Span> spans, FunctionRef<std::unique_ptr<Entity>(size_t, Span)> reuse) {
+    std::vector<std::unique_ptr<Entity>> parsed(spans.size());
+    std::vector<std::exception_ptr> errors(spans.size());
+    pool.parallelFor(spans.size(), [&](size_t i) {
+        try {
+            parsed[i] = reuse(i, spans[i]);
+            if (!parsed[i]) parsed[i] = parseEntity(spans[i]);
+        } catch (...) {
+            errors[i] = std::current_exception();
         }
+    });
+    for (auto&& error : errors) {
+        if (error) std::rethrow_exception(error);
     }
+    std::move(parsed.begin(), parsed.end(), std::back_inserter(entities));
 }
 
+void Parser::stream(FunctionRef<void(Span)> consume) {
+    auto code = input.view();
+    auto& tokens = source.tokens;
+    bool define = false;
+    while (!code.empty()) {
+        auto line = nextLine(code);
+        size_t count = tokens.size();
+        source.lines.push_back(line);
+        LineTokenizer(source, line);
+        if (tokens.size() != count) {
+            auto head = tokens[count].front();
+            if (define) {
+                if (head.type != TokenType::RBRACE) continue;
+                define = false;
+                consume({0, tokens.size()});
+            } else if (head.keyword == Keyword::DEFINE) {
+                define = true;
+                continue;
+            } else if (head.keyword == Keyword::DECLARE || source.of(head).starts_with("@")) {
+                consume({0, tokens.size()});
+            }
+        } else if (define) {
+            continue;
+        }
+        source.release();
+        input.release(code.data());
+    }
+    if (define) consume({0, tokens.size()});
+}
 
-void Parser::parseDefine() {
-    auto define = LineParser{source, nextLine()}.parseDefine();
-    std::vector<std::unique_ptr<Inst>> insts;
-    while (remains() && peekLine().front().type != TokenType::RBRACE) {
-        auto line = peekLine();
-        insts.push_back(LineParser{source, line}.parseInst());
+std::unique_ptr<Entity> Parser::parseEntity(Span span) {
+    auto head = source.tokens[span.begin];
+    auto keyword = head.front().keyword;
+    if (keyword == Keyword::DEFINE) {
+        return parseDefine(span);
+    } else if (keyword == Keyword::DECLARE) {
+        return LineParser{source, head}.parseDeclare();
+    } else {
+        return LineParser{source, head}.parseGlobalVariable();
+    }
+}
+
+std::unique_ptr<FunctionDefine> Parser::parseDefine(Span span) {
+    auto head = source.tokens[span.begin];
+    auto define = LineParser{source, head}.parseDefine();
+    auto end = span.end;
+    if (end != span.begin + 1 && source.tokens[end - 1].front().type == TokenType::RBRACE) --end;
+    std::vector<Segment> where{range(head.front(), head.back())};
+    BasicBlock* bb = nullptr;
+    for (auto i = span.begin + 1; i != end; ++i) {
+        auto line = source.tokens[i];
+        auto inst = LineParser{source, line, define.get()}.parseInst();
         auto segment = range(line.front(), line.back());
-        Token token{.line = segment.line1, .column = segment.column1, .width = segment.column2 - segment.column1};
-        std::string code(source.of(token));
-        insts.back()->code = code;
-        nextLine();
-    }
-    nextLine();
-    for (auto inst = insts.begin(); inst != insts.end(); ) {
-        std::vector<std::unique_ptr<Inst>> bb;
-        assert((*inst)->kind() == Inst::Kind::LABEL);
-        bb.push_back(std::move(*inst++));
-        while (inst != insts.end() && (*inst)->kind() != Inst::Kind::TERMINATOR) {
-            bb.push_back(std::move(*inst++));
-        }
-        assert(inst != insts.end());
-        bb.push_back(std::move(*inst++));
-        define->bbs.emplace_back(std::move(bb));
-    }
-    entities.push_back(std::move(define));
+        where.push_back(segment);
+        switch (inst->kind()) {
+            case Inst::Kind::LABEL:
+                if (bb) raise("basic block is not terminated", segment);
+                bb = define->arena.make<BasicBlock>();
+                bb->labelInst = static_cast<LabelInst*>(inst);
+                break;
+            case Inst::Kind::INTERMEDIATE:
+                if (!bb) raise("instruction is outside of any basic block", segment);
+                if (dyn_cast<PhiInst>(inst) && bb->insts.tail != bb->labelInst && !dyn_cast<PhiInst>(bb->insts.tail)) {
+                    raise("phi must be at the start of a basic block", segment);
+                }
+                break;
+            case Inst::Kind::TERMINATOR:
+                if (!bb) raise("instruction is outside of any basic block", segment);
+                bb->terminatorInst = static_cast<TerminatorInst*>(inst);
+                break;
+        }
+        bb->insts.push_back(inst);
+        if (bb->terminatorInst) {
+            bb->index = define->bbs.size();
+            define->bbs.push_back(bb);
+            bb = nullptr;
+        }
+    }
+    if (bb) raise("basic block is not terminated", source.tokens[end - 1].back());
+    resolve(*define, where);
+    return define;
 }
 
-void Parser::parseDeclare() {
-    entities.push_back(LineParser{source, nextLine()}.parseDeclare());
+Type LineParser::parseType() {
+    auto token = next();
+    auto type = typeOf(token.keyword);
+    if (!type) {
+        Error().with(ErrorMessage().error(token).text("type is expected")).raise();
+    }
+    return *type;
 }
 
-void Parser::parseGlobalVariable() {
-    entities.push_back(LineParser{source, nextLine()}.parseGlobalVariable());
+Value LineParser::parseValue(Type type) {
+    auto token = next();
+    auto text = source.of(token);
+    if (token.type != TokenType::INTEGER && token.type != TokenType::FLOATING_POINT
+            && text != "true" && text != "false" && text != "null") {
+        return named(text);
+    }
+    uint32_t constant = function->constants.intern(type, text);
+    if (constant == ConstantPool::NONE) {
+        Error().with(ErrorMessage().error(token).text("invalid").quote(nameOf(type)).text("constant")).raise();
+    }
+    return Value::ofConstant(constant);
 }
 
-Type parseType(std::string_view type) {
-    static const std::unordered_map<std::string_view, Type> TYPE {
-            {"void", Type::VOID},
-            {"i1", Type::I1},
-            {"i64", Type::I64},
-            {"double", Type::DOUBLE},
-            {"ptr", Type::PTR},
-            {"label", Type::LABEL}
-    };
-    return TYPE.at(type);
+Inst* LineParser::parseInst() {
+    auto inst = parseOperation();
+    if (remains()) Error().with(ErrorMessage().error(peek()).text("end of line is expected")).raise();
+    return inst;
 }
 
-std::unique_ptr<Inst> LineParser::parseInst() {
-    assert(remains());
-    auto inst = nextView();
+uint32_t LineParser::parseAlign() {
+    if (!remains() || peek().type != TokenType::OP_COMMA) return 0;
+    next();
+    expect(Keyword::ALIGN);
+    auto token = next();
+    auto text = source.of(token);
+    uint32_t align = 0;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.length(), align);
+    if (token.type != TokenType::INTEGER || ec != std::errc{} || ptr != text.data() + text.length() || !std::has_single_bit(align)) {
+        Error().with(ErrorMessage().error(token).text("alignment must be a power of two")).raise();
+    }
+    return align;
+}
+
+Inst* LineParser::parseOperation() {
+    auto& arena = function->arena;
+    auto token = next();
     if (remains() && peek().type == TokenType::OP_COLON) {
         next();
-        assert(!remains());
-        return std::make_unique<LabelInst>(std::string(inst));
+        return arena.make<LabelInst>(local(source.of(token)));
     }
-    std::optional<std::string_view> receiver;
+    Symbol receiver;
     if (remains() && peek().type == TokenType::OP_ASSIGN) {
         next();
-        receiver = inst;
-        assert(remains());
-        inst = nextView();
+        receiver = local(source.of(token));
+        token = next();
+    }
+    if (!isOpcode(token.keyword)) {
+        Error().with(ErrorMessage().error(token).text("unknown instruction")).raise();
     }
-    auto OPCODES_it = OPCODES.find(inst);
-    assert(OPCODES_it != OPCODES.end());
-    auto opcode = OPCODES_it->second;
+    auto opcode = opcodeOf(token.keyword);
     if (opcode == Opcode::UNREACHABLE) {
-        return std::make_unique<UnreachableInst>();
+        return arena.make<UnreachableInst>();
     } else if (opcode == Opcode::BR) {
-        auto head = nextView();
-        if (head == "label") {
-            auto br = std::make_unique<BrLabelInst>();
-            br->label = nextView().substr(1);
+        auto head = next();
+        if (head.keyword == Keyword::LABEL) {
+            auto br = arena.make<BrLabelInst>();
+            br->label = local(nextView().substr(1));
             return br;
-        } else if (head == "i1") {
-            auto br = std::make_unique<BrCondInst>();
-            br->cond = nextView();
+        } else if (head.keyword == Keyword::I1) {
+            auto br = arena.make<BrCondInst>();
+            br->cond = parseValue(Type::I1);
             expect(TokenType::OP_COMMA, "comma");
-            next();
-            br->label1 = nextView().substr(1);
+            expect(Keyword::LABEL);
+            br->label1 = local(nextView().substr(1));
             expect(TokenType::OP_COMMA, "comma");
-            next();
-            br->label2 = nextView().substr(1);
+            expect(Keyword::LABEL);
+            br->label2 = local(nextView().substr(1));
             return br;
         }
-        assert(false);
+        Error().with(ErrorMessage().error(head).quote("label").text("or").quote("i1").text("is expected")).raise();
     } else if (opcode == Opcode::RET) {
-        auto ret = std::make_unique<RetInst>();
-        ret->type = parseType(nextView());
-        if (ret->type != Type::VOID) ret->value = nextView();
+        auto ret = arena.make<RetInst>();
+        ret->type = parseType();
+        if (ret->type != Type::VOID) ret->value = parseValue(ret->type);
         return ret;
     }
-    std::unique_ptr<IntermediateInst> ret;
+    IntermediateInst* ret;
     switch (opcode) {
         case Opcode::FNEG:
-            assert(nextView() == "double");
-            ret = std::make_unique<UnaryOpInst>(nextView());
+            expect(Keyword::DOUBLE);
+            ret = arena.make<UnaryOpInst>(parseValue(Type::DOUBLE));
             break;
         case Opcode::ADD:
         case Opcode::FADD:
@@ -136,88 +248,119 @@ std::unique_ptr<Inst> LineParser::parseInst() {
         case Opcode::AND:
         case Opcode::OR:
         case Opcode::XOR: {
-            auto type = parseType(nextView());
-            auto value1 = nextView();
+            auto type = parseType();
+            auto value1 = parseValue(type);
             expect(TokenType::OP_COMMA, "comma");
-            auto value2 = nextView();
-            ret = std::make_unique<BinaryOpInst>(opcode, type, value1, value2);
+            auto value2 = parseValue(type);
+            ret = arena.make<BinaryOpInst>(opcode, type, value1, value2);
             break;
         }
-        case Opcode::ALLOCA:
-            ret = std::make_unique<AllocaInst>(parseType(nextView()));
+        case Opcode::ALLOCA: {
+            auto alloca = arena.make<AllocaInst>(parseType());
+            alloca->align = parseAlign();
+            ret = alloca;
             break;
+        }
         case Opcode::LOAD: {
-            auto type = parseType(nextView());
+            auto type = parseType();
             expect(TokenType::OP_COMMA, "comma");
-            assert(nextView() == "ptr");
-            auto from = nextView();
-            ret = std::make_unique<LoadInst>(type, from);
+            expect(Keyword::PTR);
+            auto from = parseValue(Type::PTR);
+            auto load = arena.make<LoadInst>(type, from);
+            load->align = parseAlign();
+            ret = load;
             break;
         }
         case Opcode::STORE: {
-            auto type = parseType(nextView());
-            auto from = nextView();
+            auto type = parseType();
+            auto from = parseValue(type);
             expect(TokenType::OP_COMMA, "comma");
-            assert(nextView() == "ptr");
-            auto into = nextView();
-            ret = std::make_unique<StoreInst>(type, from, into);
+            expect(Keyword::PTR);
+            auto into = parseValue(Type::PTR);
+            auto store = arena.make<StoreInst>(type, from, into);
+            store->align = parseAlign();
+            ret = store;
             break;
         }
         case Opcode::GETELEMENTPTR: {
-            assert(nextView() == "inbounds");
-            auto type = parseType(nextView());
+            expect(Keyword::INBOUNDS);
+            auto type = parseType();
             expect(TokenType::OP_COMMA, "comma");
-            assert(nextView() == "ptr");
-            auto ptr = nextView();
+            expect(Keyword::PTR);
+            auto ptr = parseValue(Type::PTR);
             expect(TokenType::OP_COMMA, "comma");
-            assert(nextView() == "i64");
-            auto offset = nextView();
-            ret = std::make_unique<GEPInst>(type, ptr, offset);
+            expect(Keyword::I64);
+            auto offset = parseValue(Type::I64);
+            ret = arena.make<GEPInst>(type, ptr, offset);
             break;
         }
         case Opcode::ICMP: {
-            auto op = IcmpInst::OPS.at(nextView());
-            auto type = parseType(nextView());
-            auto value1 = nextView();
+            auto token = next();
+            auto op = IcmpInst::of(token.keyword);
+            if (!op) Error().with(ErrorMessage().error(token).text("icmp predicate is expected")).raise();
+            auto type = parseType();
+            auto value1 = parseValue(type);
             expect(TokenType::OP_COMMA, "comma");
-            auto value2 = nextView();
-            ret = std::make_unique<IcmpInst>(type, value1, value2, op);
+            auto value2 = parseValue(type);
+            ret = arena.make<IcmpInst>(type, value1, value2, *op);
             break;
         }
         case Opcode::FCMP: {
-            auto op = FcmpInst::OPS.at(nextView());
-            auto type = parseType(nextView());
-            auto value1 = nextView();
+            auto token = next();
+            auto op = FcmpInst::of(token.keyword);
+            if (!op) Error().with(ErrorMessage().error(token).text("fcmp predicate is expected")).raise();
+            auto type = parseType();
+            auto value1 = parseValue(type);
             expect(TokenType::OP_COMMA, "comma");
-            auto value2 = nextView();
-            ret = std::make_unique<FcmpInst>(type, value1, value2, op);
+            auto value2 = parseValue(type);
+            ret = arena.make<FcmpInst>(type, value1, value2, *op);
             break;
         }
         case Opcode::SITOFP:
         case Opcode::FPTOSI:
         case Opcode::INTTOPTR:
         case Opcode::PTRTOINT: {
-            auto type1 = parseType(nextView());
-            auto value = nextView();
-            assert(nextView() == "to");
-            auto type2 = parseType(nextView());
-            ret = std::make_unique<ConvInst>(opcode, type1, type2, value);
+            auto type1 = parseType();
+            auto value = parseValue(type1);
+            expect(Keyword::TO);
+            auto type2 = parseType();
+            ret = arena.make<ConvInst>(opcode, type1, type2, value);
             break;
         }
         case Opcode::CALL: {
-            auto ret_type = parseType(nextView());
-            auto function = nextView();
-            std::vector<CallInst::TypedValue> args;
+            auto ret_type = parseType();
+            auto callee = named(nextView());
+            thread_local std::vector<CallInst::TypedValue> args;
+            args.clear();
             expect(TokenType::LPAREN, "(");
             while (peek().type != TokenType::RPAREN) {
                 if (!args.empty()) expect(TokenType::OP_COMMA, "comma");
-                auto type = parseType(nextView());
-                auto value = nextView();
+                auto type = parseType();
+                auto value = parseValue(type);
                 args.push_back({type, value});
             }
-            ret = std::make_unique<CallInst>(ret_type, function, std::move(args));
+            next();
+            ret = arena.make<CallInst>(ret_type, callee, arena.array<CallInst::TypedValue>(args));
             break;
         }
+        case Opcode::PHI: {
+            auto type = parseType();
+            thread_local std::vector<PhiInst::Incoming> incoming;
+            incoming.clear();
+            do {
+                if (!incoming.empty()) expect(TokenType::OP_COMMA, "comma");
+                expect(TokenType::LBRACKET, "[");
+                auto value = parseValue(type);
+                expect(TokenType::OP_COMMA, "comma");
+                auto label = local(nextView().substr(1));
+                expect(TokenType::RBRACKET, "]");
+                incoming.push_back({value, label});
+            } while (remains());
+            ret = arena.make<PhiInst>(type, arena.array<PhiInst::Incoming>(incoming));
+            break;
+        }
+        default:
+            unreachable();
     }
     ret->receiver = receiver;
     return ret;
@@ -226,25 +369,43 @@ std::unique_ptr<Inst> LineParser::parseInst() {
 std::unique_ptr<FunctionDefine> LineParser::parseDefine() {
     next(); // define
     next(); // return type
-    std::string name(source.of(expect(TokenType::IDENTIFIER, "identifier")));
+    Symbol name(source.of(expect(TokenType::IDENTIFIER, "identifier")));
     auto define = std::make_unique<FunctionDefine>();
-    define->name = std::move(name);
+    define->name = name;
+    expect(TokenType::LPAREN, "(");
+    while (peek().type != TokenType::RPAREN) {
+        if (!define->params.empty()) expect(TokenType::OP_COMMA, "comma");
+        auto type = parseType();
+        define->params.push_back({type, Symbol(source.of(expect(TokenType::IDENTIFIER, "identifier")), define->symbols)});
+    }
+    expect(TokenType::RPAREN, ")");
     return define;
 }
 
 std::unique_ptr<FunctionDeclare> LineParser::parseDeclare() {
     next(); // declare
     next(); // return type
-    std::string name(source.of(expect(TokenType::IDENTIFIER, "identifier")));
+    Symbol name(source.of(expect(TokenType::IDENTIFIER, "identifier")));
     auto declare = std::make_unique<FunctionDeclare>();
-    declare->name = std::move(name);
+    declare->name = name;
     return declare;
 }
 
 std::unique_ptr<GlobalVariable> LineParser::parseGlobalVariable() {
-    std::string name(source.of(expect(TokenType::IDENTIFIER, "identifier")));
+    Symbol name(source.of(expect(TokenType::IDENTIFIER, "identifier")));
     auto gv = std::make_unique<GlobalVariable>();
-    gv->name = std::move(name);
+    gv->name = name;
+    if (q - p != 4 || tokens[p].type != TokenType::OP_ASSIGN) return gv;
+    auto linkage = source.of(tokens[p + 1]);
+    auto type = typeOf(tokens[p + 2].keyword);
+    if ((linkage != "global" && linkage != "constant") || !type || *type == Type::VOID) return gv;
+    auto literal = source.of(tokens[p + 3]);
+    gv->type = *type;
+    if (literal == "zeroinitializer" || literal == "undef" || literal == "poison") {
+        gv->initializer = Constant{*type, 0};
+    } else {
+        gv->initializer = parseConstant(*type, literal);
+    }
     return gv;
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "util.hpp"
+#include "input.hpp"
+#include "pool.hpp"
 #include "lexer.hpp"
 #include "source.hpp"
 #include "entity.hpp"
@@ -12,65 +14,67 @@ struct LineParser;
 
 struct Parser {
     Source source;
-    std::string input;
+    Input input;
     std::vector<std::unique_ptr<Entity>> entities;
 
 
-    explicit Parser(std::string input) : input(std::move(input)) {}
+    explicit Parser(Input input) : input(std::move(input)) {}
 
     void tokenize() {
-        auto lines = splitLines(this->input);
-        for (auto line: lines) {
-            source.append(std::string(line));
-        }
+        source.append(input.view());
     }
 
-    void parse();
+    void tokenize(ThreadPool& pool) {
+        source.append(input.view(), pool);
+    }
 
-    using iterator = std::vector<std::vector<Token>>::iterator;
+    struct Span {
+        size_t begin, end;
+    };
 
-    void parseDeclare();
-    void parseDefine();
-    void parseGlobalVariable();
+    [[nodiscard]] std::vector<Span> scan();
+    void parse();
+    void parse(ThreadPool& pool);
+    // Parses `spans` in parallel, except where `reuse` already supplies the entity for a span.
+    void parse(ThreadPool& pool, std::span<const Span> spans, FunctionRef<std::unique_ptr<Entity>(size_t, Span)> reuse);
 
-    iterator _it;
+    // Tokenizes the input one top-level entity at a time and calls `consume` with its span, then releases
+    // its lines, tokens and input pages before reading on. Spans are found like scan() finds them, but
+    // index the tokens still held, so memory stays proportional to the largest function.
+    void stream(FunctionRef<void(Span)> consume);
 
-    [[nodiscard]] std::vector<Token>& peekLine() const {
-        return *_it;
-    }
-    std::vector<Token>& nextLine() {
-        return *_it++;
-    }
-    bool remains() {
-        return _it != source.tokens.end();
-    }
+    std::unique_ptr<Entity> parseEntity(Span span);
+    std::unique_ptr<FunctionDefine> parseDefine(Span span);
 };
 
 struct LineParser {
     Source& source;
-    std::vector<Token>::const_iterator p;
-    std::vector<Token>::const_iterator q;
+    TokenLine tokens;
+    size_t p, q;
+    // The function an instruction line belongs to: its names, labels and constants go into its scopes.
+    FunctionDefine* function;
 
-    LineParser(Source& source, std::vector<Token>& tokens): source(source), p(tokens.begin()), q(tokens.end()) {}
+    LineParser(Source& source, TokenLine tokens, FunctionDefine* function = nullptr):
+            source(source), tokens(tokens), p(0), q(tokens.size()), function(function) {}
 
     Token next() {
         if (p != q) {
-            return *p++;
+            return tokens[p++];
         } else {
             raise("unexpected termination of tokens", rewind());
         }
     }
     [[nodiscard]] Token peek() const noexcept {
-        return *p;
+        return p != q ? tokens[p] : rewind();
     }
     [[nodiscard]] Token rewind() const noexcept {
-        return *std::prev(p);
+        return tokens[p - 1];
     }
     [[nodiscard]] bool remains() const noexcept {
         return p != q;
     }
 
-    std::string_view nextView() noexcept {
+    std::string_view nextView() {
         return source.of(next());
     }
 
@@ -83,11 +87,35 @@ struct LineParser {
         return token;
     }
 
+    Token expect(Keyword keyword) {
+        auto token = next();
+        if (token.keyword != keyword) {
+            Error().with(ErrorMessage().error(token).quote(KEYWORD_NAME[size_t(keyword)]).text("is expected")).raise();
+        }
+        return token;
+    }
+
+    [[nodiscard]] Symbol local(std::string_view text) {
+        return Symbol(text, function->symbols);
+    }
+    // A named operand: registers are local to the function, anything else is global.
+    [[nodiscard]] Value named(std::string_view text) {
+        return text.starts_with('%') ? Value(local(text)) : Value(text);
+    }
+
+    Type parseType();
+    // Reads an operand of `type`. Literal constants go into the function's constants here, once.
+    Value parseValue(Type type);
+
     std::unique_ptr<FunctionDeclare> parseDeclare();
     std::unique_ptr<FunctionDefine> parseDefine();
     std::unique_ptr<GlobalVariable> parseGlobalVariable();
 
-    std::unique_ptr<Inst> parseInst();
+    // Parses the whole line as one instruction; tokens left over after it are an error.
+    Inst* parseInst();
+    Inst* parseOperation();
+    // Reads an optional trailing ", align <n>" and returns n, or 0 without one.
+    uint32_t parseAlign();
 
 
 };
@@ -0,0 +1,87 @@
+#include "pass.hpp"
+#include "sccp.hpp"
+#include "gvn.hpp"
+#include "licm.hpp"
+#include "mem2reg.hpp"
+#include "adce.hpp"
+
+#include <algorithm>
+
+namespace YAOPT {
+
+namespace {
+
+constexpr FunctionPass FUNCTION_PASSES[] = {
+    {"mem2reg", mem2reg},
+    {"sccp", sccp},
+    {"gvn", gvn},
+    {"adce", adce},
+    {"dce", adce},
+    {"licm", licm},
+};
+
+}
+
+std::span<const FunctionPass> functionPasses() noexcept {
+    return FUNCTION_PASSES;
+}
+
+FunctionPass const* findPass(std::string_view name) noexcept {
+    auto pass = std::find_if(std::begin(FUNCTION_PASSES), std::end(FUNCTION_PASSES), [&](auto&& pass) { return pass.name == name; });
+    return pass != std::end(FUNCTION_PASSES) ? pass : nullptr;
+}
+
+void FunctionPassManager::run(FunctionDefine& define, std::span<size_t> changes) const {
+    for (size_t i = 0; i < passes.size(); ++i) {
+        auto result = passes[i]->run(define);
+        define.invalidate(result.changed);
+        changes[i] += result.changes;
+    }
+}
+
+void FunctionPassManager::report(FunctionDefine const& define, std::span<const size_t> changes, FILE* out) const {
+    auto name = define.name.view();
+    for (size_t i = 0; i < passes.size() && i < changes.size(); ++i) {
+        auto pass = passes[i]->name;
+        fprintf(out, "%.*s: %.*s: %zu\n", int(pass.length()), pass.data(), int(name.length()), name.data(), changes[i]);
+    }
+    for (size_t i = 0; i < size_t(Analysis::COUNT); ++i) {
+        auto analysis = ANALYSIS_NAME[i];
+        fprintf(out, "%.*s computed: %.*s: %zu\n", int(analysis.length()), analysis.data(),
+                int(name.length()), name.data(), define.analyses.computed[i]);
+    }
+}
+
+std::string_view parsePipeline(std::string_view text, FunctionPassManager& manager) {
+    while (!text.empty()) {
+        auto name = text.substr(0, text.find(','));
+        auto pass = findPass(name);
+        if (!pass) return name.empty() ? text : name;
+        manager.passes.push_back(pass);
+        text.remove_prefix(std::min(text.length(), name.length() + 1));
+    }
+    return {};
+}
+
+void ModulePassManager::run(std::span<const std::unique_ptr<Entity>> entities, ThreadPool& pool) {
+    size_t width = functions.passes.size();
+    changes.assign(entities.size() * width, 0);
+    if (!width) return;
+    pool.parallelFor(entities.size(), [&](size_t i) {
+        if (auto define = dynamic_cast<FunctionDefine*>(entities[i].get())) {
+            functions.run(*define, std::span(changes).subspan(i * width, width));
+        }
+    });
+}
+
+void ModulePassManager::report(std::span<const std::unique_ptr<Entity>> entities, FILE* out) const {
+    size_t width = functions.passes.size();
+    for (size_t i = 0; i < entities.size(); ++i) {
+        auto define = dynamic_cast<FunctionDefine const*>(entities[i].get());
+        if (!define) continue;
+        auto begin = std::min(i * width, changes.size());
+        functions.report(*define, std::span(changes).subspan(begin, std::min(width, changes.size() - begin)), out);
+    }
+}
+
+}
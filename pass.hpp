@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "entity.hpp"
+#include "pool.hpp"
+
+namespace YAOPT {
+
+struct FunctionPass {
+    std::string_view name;
+    PassResult (*run)(FunctionDefine&);
+};
+
+// Every registered pass in registry order; an alias is a later entry with the same `run`.
+[[nodiscard]] std::span<const FunctionPass> functionPasses() noexcept;
+[[nodiscard]] FunctionPass const* findPass(std::string_view name) noexcept;
+
+// Runs its passes over one function in order. After each pass the function's cached analyses are
+// invalidated by what the pass reported, so an analysis the pass left intact is reused by the next one.
+struct FunctionPassManager {
+    std::vector<FunctionPass const*> passes;
+
+    // Adds the number of changes made by each pass to `changes`, which is indexed like `passes`.
+    void run(FunctionDefine& define, std::span<size_t> changes) const;
+
+    // Prints "<pass>: @<function>: <changes>" per pass, then how many times each analysis was computed.
+    void report(FunctionDefine const& define, std::span<const size_t> changes, FILE* out) const;
+};
+
+// Parses a comma separated list of function passes such as "mem2reg,sccp,gvn,adce" and appends it to
+// `manager`. Returns the unknown pass name if there is one, and an empty view otherwise.
+[[nodiscard]] std::string_view parsePipeline(std::string_view text, FunctionPassManager& manager);
+
+// Runs a function pipeline over every definition of a module, one function per task, and keeps the
+// per-function change counts for reporting.
+struct ModulePassManager {
+    FunctionPassManager functions;
+    std::vector<size_t> changes;
+
+    void run(std::span<const std::unique_ptr<Entity>> entities, ThreadPool& pool);
+
+    // Reports every definition in module order, as FunctionPassManager::report does.
+    void report(std::span<const std::unique_ptr<Entity>> entities, FILE* out) const;
+};
+
+}
@@ -0,0 +1,105 @@
+#include "pool.hpp"
+
+namespace YAOPT {
+
+ThreadPool::ThreadPool(size_t threads): queues(std::make_unique<Queue[]>(threads)) {
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back([this, i] { run(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto&& worker : workers) {
+        worker.join();
+    }
+}
+
+bool ThreadPool::pop(size_t self, size_t& index) {
+    auto& queue = queues[self];
+    std::lock_guard lock(queue.mutex);
+    if (queue.begin == queue.end) return false;
+    index = queue.begin++;
+    return true;
+}
+
+bool ThreadPool::steal(size_t self) {
+    for (size_t i = 1; i < size(); ++i) {
+        auto& victim = queues[(self + i) % size()];
+        size_t begin, end;
+        {
+            std::lock_guard lock(victim.mutex);
+            if (victim.begin == victim.end) continue;
+            end = victim.end;
+            begin = victim.end -= (victim.end - victim.begin + 1) / 2;
+        }
+        auto& queue = queues[self];
+        std::lock_guard lock(queue.mutex);
+        queue.begin = begin;
+        queue.end = end;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::drain(size_t self, std::function<void(size_t)> const& body) {
+    do {
+        for (size_t index; pop(self, index); ) {
+            body(index);
+        }
+    } while (steal(self));
+}
+
+void ThreadPool::run(size_t self) {
+    size_t seen = 0;
+    while (true) {
+        std::function<void(size_t)> const* body;
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            if (!job) continue;
+            body = job;
+            ++active;
+        }
+        drain(self, *body);
+        {
+            std::lock_guard lock(mutex);
+            --active;
+        }
+        done.notify_all();
+    }
+}
+
+void ThreadPool::parallelFor(size_t n, std::function<void(size_t)> const& body) {
+    if (workers.empty() || n <= 1) {
+        for (size_t i = 0; i < n; ++i) body(i);
+        return;
+    }
+    {
+        std::lock_guard lock(mutex);
+        for (size_t i = 0; i < size(); ++i) {
+            std::lock_guard guard(queues[i].mutex);
+            queues[i].begin = n * i / size();
+            queues[i].end = n * (i + 1) / size();
+        }
+        job = &body;
+        ++generation;
+    }
+    wake.notify_all();
+    drain(0, body);
+    std::unique_lock lock(mutex);
+    done.wait(lock, [&] { return active == 0; });
+    job = nullptr;
+}
+
+size_t defaultThreads() noexcept {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace YAOPT {
+
+struct ThreadPool {
+    explicit ThreadPool(size_t threads);
+    ThreadPool(ThreadPool const&) = delete;
+    ~ThreadPool();
+
+    [[nodiscard]] size_t size() const noexcept {
+        return workers.size() + 1;
+    }
+
+    void parallelFor(size_t n, std::function<void(size_t)> const& body);
+
+private:
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        size_t begin = 0, end = 0;
+    };
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<Queue[]> queues;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    std::function<void(size_t)> const* job = nullptr;
+    size_t generation = 0, active = 0;
+    bool stopping = false;
+
+    void run(size_t self);
+    void drain(size_t self, std::function<void(size_t)> const& body);
+    bool pop(size_t self, size_t& index);
+    bool steal(size_t self);
+};
+
+[[nodiscard]] size_t defaultThreads() noexcept;
+
+}
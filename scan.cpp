@@ -0,0 +1,86 @@
+#include "scan.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define YAOPT_X86 1
+#endif
+
+namespace YAOPT {
+
+static const char* findScalar(const char* p, const char* end, char c1, char c2) noexcept {
+    while (p != end && *p != c1 && *p != c2) ++p;
+    return p;
+}
+
+static const char* skipScalar(const char* p, const char* end, char c1, char c2) noexcept {
+    while (p != end && (*p == c1 || *p == c2)) ++p;
+    return p;
+}
+
+#ifdef YAOPT_X86
+
+static const char* findSSE2(const char* p, const char* end, char c1, char c2) noexcept {
+    const __m128i a = _mm_set1_epi8(c1), b = _mm_set1_epi8(c2);
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, a), _mm_cmpeq_epi8(v, b)));
+        if (mask) return p + __builtin_ctz(mask);
+    }
+    return findScalar(p, end, c1, c2);
+}
+
+static const char* skipSSE2(const char* p, const char* end, char c1, char c2) noexcept {
+    const __m128i a = _mm_set1_epi8(c1), b = _mm_set1_epi8(c2);
+    for (; end - p >= 16; p += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = ~_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, a), _mm_cmpeq_epi8(v, b))) & 0xFFFF;
+        if (mask) return p + __builtin_ctz(mask);
+    }
+    return skipScalar(p, end, c1, c2);
+}
+
+__attribute__((target("avx2")))
+static const char* findAVX2(const char* p, const char* end, char c1, char c2) noexcept {
+    const __m256i a = _mm256_set1_epi8(c1), b = _mm256_set1_epi8(c2);
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, a), _mm256_cmpeq_epi8(v, b)));
+        if (mask) return p + __builtin_ctz(mask);
+    }
+    return findSSE2(p, end, c1, c2);
+}
+
+__attribute__((target("avx2")))
+static const char* skipAVX2(const char* p, const char* end, char c1, char c2) noexcept {
+    const __m256i a = _mm256_set1_epi8(c1), b = _mm256_set1_epi8(c2);
+    for (; end - p >= 32; p += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned mask = ~_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, a), _mm256_cmpeq_epi8(v, b)));
+        if (mask) return p + __builtin_ctz(mask);
+    }
+    return skipSSE2(p, end, c1, c2);
+}
+
+#endif
+
+static const Scanner SCALAR{"scalar", findScalar, skipScalar};
+#ifdef YAOPT_X86
+static const Scanner SSE2{"sse2", findSSE2, skipSSE2};
+static const Scanner AVX2{"avx2", findAVX2, skipAVX2};
+#endif
+
+std::vector<const Scanner*> scanners() {
+    std::vector<const Scanner*> result{&SCALAR};
+#ifdef YAOPT_X86
+    result.push_back(&SSE2);
+    if (__builtin_cpu_supports("avx2")) result.push_back(&AVX2);
+#endif
+    return result;
+}
+
+const Scanner& scanner() noexcept {
+    static const Scanner& selected = *scanners().back();
+    return selected;
+}
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace YAOPT {
+
+enum CharClass : uint8_t {
+    DECIMAL = 1 << 0,
+    IDENTIFIER_START = 1 << 1,
+    IDENTIFIER_PART = 1 << 2,
+    PUNCTUATION = 1 << 3,
+    BLANK = 1 << 4,
+    LINE_BREAK = 1 << 5,
+};
+
+constexpr std::array<uint8_t, 256> CHAR_CLASS = [] {
+    std::array<uint8_t, 256> table{};
+    for (int ch = '0'; ch <= '9'; ++ch) table[ch] |= DECIMAL | IDENTIFIER_PART;
+    for (int ch = 'a'; ch <= 'z'; ++ch) table[ch] |= IDENTIFIER_START | IDENTIFIER_PART;
+    for (int ch = 'A'; ch <= 'Z'; ++ch) table[ch] |= IDENTIFIER_START | IDENTIFIER_PART;
+    for (unsigned char ch : std::string_view("!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~")) table[ch] |= PUNCTUATION;
+    for (unsigned char ch : std::string_view("@%\"_")) table[ch] |= IDENTIFIER_START;
+    for (unsigned char ch : std::string_view("\"\\_")) table[ch] |= IDENTIFIER_PART;
+    table[' '] |= BLANK;
+    table['\t'] |= BLANK;
+    table['\n'] |= LINE_BREAK;
+    table['\r'] |= LINE_BREAK;
+    return table;
+}();
+
+[[nodiscard]] constexpr bool is(char ch, uint8_t mask) noexcept {
+    return CHAR_CLASS[static_cast<unsigned char>(ch)] & mask;
+}
+
+struct Scanner {
+    const char* name;
+    // first byte in [p, end) equal to c1 or c2, or end
+    const char* (*find)(const char* p, const char* end, char c1, char c2) noexcept;
+    // first byte in [p, end) equal to neither c1 nor c2, or end
+    const char* (*skip)(const char* p, const char* end, char c1, char c2) noexcept;
+
+    [[nodiscard]] const char* findLineBreak(const char* p, const char* end) const noexcept {
+        return find(p, end, '\n', '\r');
+    }
+    [[nodiscard]] const char* findTab(const char* p, const char* end) const noexcept {
+        return find(p, end, '\t', '\t');
+    }
+    [[nodiscard]] const char* skipBlanks(const char* p, const char* end) const noexcept {
+        return skip(p, end, ' ', '\t');
+    }
+};
+
+[[nodiscard]] std::vector<const Scanner*> scanners();
+[[nodiscard]] const Scanner& scanner() noexcept;
+
+}
@@ -0,0 +1,243 @@
+#include "sccp.hpp"
+#include "fold.hpp"
+
+#include <unordered_map>
+
+namespace YAOPT {
+
+namespace {
+
+struct Lattice {
+    enum State : uint8_t {
+        UNKNOWN, CONSTANT, OVERDEFINED
+    } state = UNKNOWN;
+    Constant value{};
+};
+
+struct Solver {
+    FunctionDefine& define;
+    SSA& ssa;
+    CFG const& cfg;
+    std::vector<Lattice> values;
+    std::vector<bool> executableEdges, executableBlocks;
+    std::unordered_map<Inst const*, uint32_t> parent;
+    std::vector<uint32_t> blockWork, valueWork;
+
+    explicit Solver(FunctionDefine& define):
+            define(define), ssa(define.ssa), cfg(define.cfg()), values(ssa.size()),
+            executableEdges(cfg.succs.size()), executableBlocks(cfg.size()) {
+        for (uint32_t i = 0; i < define.params.size(); ++i) {
+            values[i].state = Lattice::OVERDEFINED;
+        }
+        for (auto bb : define.bbs) {
+            for (auto inst : bb->insts) parent.emplace(inst, bb->index);
+        }
+    }
+
+    [[nodiscard]] Lattice operand(Value const& value, Type type) {
+        uint32_t constant = value.constant;
+        if (value.reg != Value::NONE) {
+            auto& slot = ssa.slots[ssa.find(value.reg)];
+            if (!slot.immediate) return values[ssa.find(value.reg)];
+            constant = slot.constant;
+        }
+        if (constant != Value::NONE) {
+            auto& entry = ConstantPool::at(constant);
+            if (entry.value.type == type) return {Lattice::CONSTANT, entry.value};
+            if (auto parsed = parseConstant(type, entry.text)) return {Lattice::CONSTANT, *parsed};
+        }
+        return {Lattice::OVERDEFINED};
+    }
+
+    template<typename F>
+    [[nodiscard]] static Lattice apply(std::initializer_list<Lattice> operands, F&& f) {
+        for (auto&& operand : operands) {
+            if (operand.state == Lattice::OVERDEFINED) return {Lattice::OVERDEFINED};
+        }
+        for (auto&& operand : operands) {
+            if (operand.state == Lattice::UNKNOWN) return {};
+        }
+        if (std::optional<Constant> result = f()) return {Lattice::CONSTANT, *result};
+        return {Lattice::OVERDEFINED};
+    }
+
+    [[nodiscard]] bool executable(uint32_t from, uint32_t to) const noexcept {
+        for (uint32_t edge = cfg.succBegin[from]; edge != cfg.succBegin[from + 1]; ++edge) {
+            if (cfg.succs[edge] == to && executableEdges[edge]) return true;
+        }
+        return false;
+    }
+
+    // Only values flowing in along executable edges take part in the meet.
+    [[nodiscard]] Lattice evaluate(PhiInst* phi, uint32_t block) {
+        Lattice result;
+        for (auto&& in : phi->incoming) {
+            if (!executable(in.block->index, block)) continue;
+            auto value = operand(in.value, phi->type);
+            if (value.state == Lattice::UNKNOWN) continue;
+            if (value.state == Lattice::OVERDEFINED || (result.state == Lattice::CONSTANT && result.value != value.value)) {
+                return {Lattice::OVERDEFINED};
+            }
+            result = value;
+        }
+        return result;
+    }
+
+    [[nodiscard]] Lattice evaluate(Inst* inst, uint32_t block) {
+        if (auto phi = dyn_cast<PhiInst>(inst)) return evaluate(phi, block);
+        if (auto binary = dyn_cast<BinaryOpInst>(inst)) {
+            auto a = operand(binary->value1, binary->type), b = operand(binary->value2, binary->type);
+            return apply({a, b}, [&] { return fold(binary->opcode, a.value, b.value); });
+        }
+        if (auto unary = dyn_cast<UnaryOpInst>(inst)) {
+            auto a = operand(unary->value, unary->type);
+            return apply({a}, [&] { return std::optional(fneg(a.value)); });
+        }
+        if (auto icmp = dyn_cast<IcmpInst>(inst)) {
+            auto a = operand(icmp->value1, icmp->type), b = operand(icmp->value2, icmp->type);
+            return apply({a, b}, [&] { return fold(icmp->op, a.value, b.value); });
+        }
+        if (auto fcmp = dyn_cast<FcmpInst>(inst)) {
+            auto a = operand(fcmp->value1, fcmp->type), b = operand(fcmp->value2, fcmp->type);
+            return apply({a, b}, [&] { return fold(fcmp->op, a.value, b.value); });
+        }
+        if (auto conv = dyn_cast<ConvInst>(inst)) {
+            auto a = operand(conv->value, conv->type1);
+            return apply({a}, [&] { return fold(conv->opcode, a.value, conv->type2); });
+        }
+        return {Lattice::OVERDEFINED};
+    }
+
+    void update(uint32_t reg, Lattice result) {
+        auto& current = values[reg];
+        if (result.state == Lattice::CONSTANT && current.state == Lattice::CONSTANT && result.value != current.value) {
+            result.state = Lattice::OVERDEFINED;
+        }
+        if (result.state <= current.state) return;
+        current = result;
+        valueWork.push_back(reg);
+    }
+
+    void markEdge(uint32_t block, uint32_t successor) {
+        uint32_t edge = cfg.succBegin[block] + successor;
+        if (executableEdges[edge]) return;
+        executableEdges[edge] = true;
+        uint32_t target = cfg.succs[edge];
+        if (executableBlocks[target]) {
+            for (auto inst : define.bbs[target]->insts) {
+                if (dyn_cast<PhiInst>(inst)) visit(inst, target);
+            }
+            return;
+        }
+        executableBlocks[target] = true;
+        blockWork.push_back(target);
+    }
+
+    void visit(Inst* inst, uint32_t block) {
+        switch (inst->kind()) {
+            case Inst::Kind::INTERMEDIATE:
+                if (auto number = static_cast<IntermediateInst*>(inst)->number; number != Value::NONE) {
+                    update(number, evaluate(inst, block));
+                }
+                break;
+            case Inst::Kind::TERMINATOR:
+                if (dyn_cast<BrLabelInst>(inst)) {
+                    markEdge(block, 0);
+                } else if (auto br = dyn_cast<BrCondInst>(inst)) {
+                    auto cond = operand(br->cond, Type::I1);
+                    if (cond.state == Lattice::CONSTANT) {
+                        markEdge(block, cond.value.bits ? 0 : 1);
+                    } else if (cond.state == Lattice::OVERDEFINED) {
+                        markEdge(block, 0);
+                        markEdge(block, 1);
+                    }
+                }
+                break;
+            case Inst::Kind::LABEL:
+                break;
+        }
+    }
+
+    // Values that stay unknown can only come from malformed cycles; treat their branches as going both ways.
+    bool settle() {
+        for (auto bb : define.bbs) {
+            auto br = dyn_cast<BrCondInst>(bb->terminatorInst);
+            if (!br || !executableBlocks[bb->index] || operand(br->cond, Type::I1).state != Lattice::UNKNOWN) continue;
+            markEdge(bb->index, 0);
+            markEdge(bb->index, 1);
+        }
+        return !blockWork.empty();
+    }
+
+    void solve() {
+        executableBlocks[cfg.entry] = true;
+        blockWork.push_back(cfg.entry);
+        while (!blockWork.empty() || !valueWork.empty() || settle()) {
+            while (!valueWork.empty()) {
+                uint32_t reg = valueWork.back();
+                valueWork.pop_back();
+                ssa.forEachUse(reg, [&](SSA::Use const& use) {
+                    uint32_t block = parent.at(use.user);
+                    if (executableBlocks[block]) visit(use.user, block);
+                });
+            }
+            if (!blockWork.empty()) {
+                uint32_t block = blockWork.back();
+                blockWork.pop_back();
+                for (auto inst : define.bbs[block]->insts) visit(inst, block);
+            }
+        }
+    }
+
+    PassResult rewrite() {
+        size_t changes = 0, branches = 0;
+        for (auto bb : define.bbs) {
+            if (!executableBlocks[bb->index]) continue;
+            for (auto it = bb->insts.begin(); it != bb->insts.end();) {
+                auto inst = *it;
+                ++it;
+                if (inst->kind() != Inst::Kind::INTERMEDIATE) continue;
+                if (auto phi = dyn_cast<PhiInst>(inst)) {
+                    uint32_t block = bb->index;
+                    changes += prune(ssa, phi, [&](PhiInst::Incoming const& in) { return executable(in.block->index, block); });
+                }
+                uint32_t number = static_cast<IntermediateInst*>(inst)->number;
+                if (number == Value::NONE || values[number].state != Lattice::CONSTANT) continue;
+                uint32_t constant = define.constants.intern(values[number].value);
+                if (constant == ConstantPool::NONE) continue;
+                ssa.replaceAllUsesWith(number, ssa.immediate(Value::ofConstant(constant)));
+                ssa.drop(inst);
+                bb->insts.erase(inst);
+                ++changes;
+            }
+            if (auto br = dyn_cast<BrCondInst>(bb->terminatorInst)) {
+                auto cond = operand(br->cond, Type::I1);
+                if (cond.state != Lattice::CONSTANT) continue;
+                auto jump = define.arena.make<BrLabelInst>();
+                jump->label = cond.value.bits ? br->label1 : br->label2;
+                jump->target = cond.value.bits ? br->target1 : br->target2;
+                ssa.drop(br);
+                bb->insts.erase(br);
+                bb->insts.push_back(jump);
+                bb->terminatorInst = jump;
+                ++branches;
+            }
+        }
+        branches += removeBlocks(define, [&](BasicBlock const* bb) { return !executableBlocks[bb->index]; });
+        if (branches) return {changes + branches, Changed::CONTROL};
+        return {changes, changes ? Changed::VALUES : Changed::NOTHING};
+    }
+};
+
+}
+
+PassResult sccp(FunctionDefine& define) {
+    if (define.bbs.empty()) return {};
+    Solver solver(define);
+    solver.solve();
+    auto result = solver.rewrite();
+    if (result.changes) define.ssa.flush();
+    return result;
+}
+
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "entity.hpp"
+
+namespace YAOPT {
+
+// Sparse conditional constant propagation (Wegman and Zadeck): folds constant values, turns branches on
+// constant conditions into unconditional ones and drops the blocks that become unreachable.
+// Reports the number of values, branches and blocks it removed.
+PassResult sccp(FunctionDefine& define);
+
+}
@@ -0,0 +1,86 @@
+#include "sink.hpp"
+
+namespace YAOPT {
+
+void StringSink::overflow(size_t size) {
+    size_t used = this->size();
+    buffer.resize(std::max({buffer.size() * 2, used + size, size_t(256)}));
+    cursor = buffer.data() + used;
+    limit = buffer.data() + buffer.size();
+}
+
+FileSink::FileSink(FILE* file, bool async): file(file) {
+    buffers[0] = std::make_unique<char[]>(CAPACITY);
+    cursor = buffers[0].get();
+    limit = cursor + CAPACITY;
+    if (async) {
+        buffers[1] = std::make_unique<char[]>(CAPACITY);
+        writer = std::thread([this] { drain(); });
+    }
+}
+
+FileSink::~FileSink() {
+    flush();
+    if (writer.joinable()) {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+    }
+}
+
+void FileSink::drain() {
+    std::unique_lock lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return pending || stopping; });
+        if (!pending) return;
+        auto data = pending;
+        size_t size = pendingSize;
+        lock.unlock();
+        bool written = fwrite(data, 1, size, file) == size;
+        lock.lock();
+        failed |= !written;
+        pending = nullptr;
+        done.notify_one();
+    }
+}
+
+void FileSink::wait() {
+    std::unique_lock lock(mutex);
+    done.wait(lock, [this] { return !pending; });
+}
+
+void FileSink::submit() {
+    auto data = buffers[current].get();
+    size_t size = cursor - data;
+    if (!writer.joinable()) {
+        failed |= fwrite(data, 1, size, file) != size;
+    } else if (size) {
+        wait();
+        {
+            std::lock_guard lock(mutex);
+            pending = data;
+            pendingSize = size;
+        }
+        wake.notify_one();
+        current ^= 1;
+    }
+    cursor = buffers[current].get();
+    limit = cursor + CAPACITY;
+}
+
+void FileSink::overflow(size_t) {
+    submit();
+}
+
+bool FileSink::flush() {
+    submit();
+    if (writer.joinable()) wait();
+    std::lock_guard lock(mutex);
+    failed |= fflush(file) != 0;
+    return !failed;
+}
+
+}
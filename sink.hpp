@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace YAOPT {
+
+// Buffered output that serializers write into directly. The buffer belongs to the subclass, which decides
+// what happens when it is full: StringSink grows it, FileSink writes it out.
+struct Sink {
+    Sink(Sink const&) = delete;
+    Sink& operator=(Sink const&) = delete;
+    virtual ~Sink() = default;
+
+    void put(char c) {
+        if (cursor == limit) overflow(1);
+        *cursor++ = c;
+    }
+    void put(std::string_view text) {
+        if (size_t(limit - cursor) < text.size()) return spill(text);
+        std::memcpy(cursor, text.data(), text.size());
+        cursor += text.size();
+    }
+    template<typename... Args>
+    void print(Args const&... args) {
+        (put(args), ...);
+    }
+
+protected:
+    char* cursor = nullptr;
+    char* limit = nullptr;
+
+    Sink() = default;
+
+    // Makes room for at least one more byte, and for `size` when the buffer can hold that many.
+    virtual void overflow(size_t size) = 0;
+
+private:
+    void spill(std::string_view text) {
+        while (!text.empty()) {
+            if (cursor == limit) overflow(text.size());
+            size_t n = std::min(text.size(), size_t(limit - cursor));
+            std::memcpy(cursor, text.data(), n);
+            cursor += n;
+            text.remove_prefix(n);
+        }
+    }
+};
+
+struct StringSink : Sink {
+    StringSink() = default;
+
+    [[nodiscard]] size_t size() const noexcept {
+        return cursor ? cursor - buffer.data() : 0;
+    }
+    [[nodiscard]] std::string take() {
+        buffer.resize(size());
+        cursor = limit = nullptr;
+        return std::move(buffer);
+    }
+
+private:
+    std::string buffer;
+
+    void overflow(size_t size) override;
+};
+
+// Writes whole buffers with fwrite. In async mode a writer thread drains one buffer while the caller
+// fills the other, so formatting and I/O overlap.
+struct FileSink : Sink {
+    static constexpr size_t CAPACITY = size_t(1) << 20;
+
+    explicit FileSink(FILE* file, bool async = false);
+    ~FileSink() override;
+
+    // Writes out everything put so far and flushes the file. Returns false if any write failed.
+    bool flush();
+
+private:
+    FILE* file;
+    std::unique_ptr<char[]> buffers[2];
+    size_t current = 0;
+    bool failed = false;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+    char const* pending = nullptr;
+    size_t pendingSize = 0;
+    bool stopping = false;
+
+    void overflow(size_t size) override;
+    void submit();
+    void wait();
+    void drain();
+};
+
+}
@@ -1,29 +1,156 @@
 #include "lexer.hpp"
 #include "source.hpp"
+#include "diagnostics.hpp"
+#include "pool.hpp"
+
+#include <exception>
 
 namespace YAOPT {
 
 std::string_view Source::of(Token token) const noexcept {
-    return lines.at(token.line).operator std::string_view().substr(token.column, token.width);
-}
-
-void Source::append(std::string const& code) {
-    for (auto original : splitLines(code)) {
-        std::string transformed;
-        size_t width = 0;
-        for (auto ch : original) {
-            if (ch == '\t') {
-                size_t padding = 4 - (width & 3);
-                transformed += std::string(padding, ' ');
-                width += padding;
-            } else {
-                transformed += ch;
-                ++width;
+    return lines.at(token.line - base).substr(token.column, token.width);
+}
+
+std::string Source::expand(size_t line) const {
+    std::string transformed;
+    for (auto ch : lines.at(line - base)) {
+        if (ch == '\t') {
+            transformed += std::string(4 - (transformed.length() & 3), ' ');
+        } else {
+            transformed += ch;
+        }
+    }
+    return transformed;
+}
+
+size_t Source::display(size_t line, size_t column) const {
+    auto original = lines.at(line - base);
+    if (scanner().findTab(original.begin(), original.end()) == original.end()) return column;
+    size_t width = 0;
+    for (size_t i = 0; i < column && i < original.length(); ++i) {
+        width += original[i] == '\t' ? 4 - (width & 3) : 1;
+    }
+    return width + (column > original.length() ? column - original.length() : 0);
+}
+
+void Source::append(std::string_view code) {
+    for (auto line : splitLines(code)) {
+        lines.push_back(line);
+        LineTokenizer(*this, line);
+    }
+}
+
+void Source::append(std::string_view code, ThreadPool& pool) {
+    constexpr size_t MIN_CHUNK = 1 << 16;
+    size_t count = pool.size() == 1 ? 1 : std::min(pool.size() * 4, code.length() / MIN_CHUNK + 1);
+    if (count <= 1) {
+        append(code);
+        return;
+    }
+    struct Chunk {
+        std::string_view code{};
+        std::vector<std::string_view> lines{};
+        TokenStream tokens{};
+        std::vector<Token> brackets{};
+        std::exception_ptr error{};
+    };
+    std::vector<Chunk> chunks;
+    const char* begin = code.begin();
+    for (size_t i = 1; i <= count; ++i) {
+        const char* end = code.begin() + code.length() * i / count;
+        if (i == count) {
+            end = code.end();
+        } else {
+            while (end < code.end() && end[-1] != '\n') ++end;
+        }
+        if (begin != end || i == count) {
+            chunks.push_back({.code = {begin, end}});
+        }
+        begin = end;
+    }
+    pool.parallelFor(chunks.size(), [&](size_t i) {
+        auto& chunk = chunks[i];
+        chunk.lines = splitLines(chunk.code);
+        if (i + 1 != chunks.size()) chunk.lines.pop_back();
+    });
+    std::vector<size_t> bases;
+    size_t total = lines.size();
+    for (auto&& chunk : chunks) {
+        bases.push_back(total);
+        total += chunk.lines.size();
+    }
+    lines.resize(total);
+    pool.parallelFor(chunks.size(), [&](size_t i) {
+        auto& chunk = chunks[i];
+        std::copy(chunk.lines.begin(), chunk.lines.end(), lines.begin() + bases[i]);
+        try {
+            for (size_t j = 0; j < chunk.lines.size(); ++j) {
+                LineTokenizer(*this, chunk.lines[j], base + bases[i] + j, chunk.tokens, &chunk.brackets);
+            }
+        } catch (...) {
+            chunk.error = std::current_exception();
+        }
+    });
+    for (auto&& chunk : chunks) {
+        for (auto&& token : chunk.brackets) {
+            bracket(token);
+        }
+        if (chunk.error) std::rethrow_exception(chunk.error);
+        tokens.append(chunk.tokens);
+        chunk.tokens = {};
+    }
+}
+
+void Source::release() noexcept {
+    base += lines.size();
+    lines.clear();
+    tokens.clear();
+}
+
+void Source::bracket(Token token) {
+    switch (token.type) {
+        case TokenType::LPAREN:
+        case TokenType::LBRACKET:
+        case TokenType::LBRACE:
+            greedy.push_back(token);
+            break;
+        case TokenType::RPAREN:
+            checkGreedy(token, "(", ")", TokenType::LPAREN);
+            break;
+        case TokenType::RBRACKET:
+            checkGreedy(token, "[", "]", TokenType::LBRACKET);
+            break;
+        case TokenType::RBRACE:
+            checkGreedy(token, "{", "}", TokenType::LBRACE);
+            break;
+        default:
+            break;
+    }
+}
+
+void Source::checkGreedy(Token token, const char* left, const char* right, TokenType match) {
+    if (greedy.empty()) {
+        Error().with(
+                ErrorMessage().error(token)
+                .text("stray").quote(right).text("without").quote(left).text("to match")
+                ).raise();
+    }
+    if (greedy.back().type != match) {
+        Error error;
+        error.with(ErrorMessage().error(token).quote(right).text("mismatch"));
+        error.with(ErrorMessage().note(greedy.back()).quote(left).text("expected here"));
+        for (auto it = greedy.rbegin(); it != greedy.rend(); ++it) {
+            if (it->type == match) {
+                error.with(ErrorMessage().note(*it).text("nearest matching").quote(left).text("is here"));
+                break;
             }
         }
-        lines.emplace_back(std::move(transformed));
-        LineTokenizer(*this, lines.back());
+        if (error.messages.size() < 3) {
+            error.with(ErrorMessage().note().text("stray").quote(right).text("without").quote(left).text("to match"));
+        }
+        error.raise();
     }
+    greedy.pop_back();
 }
 
-}
\ No newline at end of file
+}
@@ -9,14 +9,29 @@
 namespace YAOPT {
 
 struct Token;
+struct ThreadPool;
 
 struct Source {
-    std::vector<std::string> lines;
-    std::vector<std::vector<Token>> tokens;
+    // Line number of lines[0]; lines before it have been released.
+    size_t base = 0;
+    std::vector<std::string_view> lines;
+    TokenStream tokens;
     std::vector<Token> greedy;
 
+    [[nodiscard]] bool has(size_t line) const noexcept {
+        return line >= base && line - base < lines.size();
+    }
     [[nodiscard]] std::string_view of(Token token) const noexcept;
-    void append(std::string const& code);
+    [[nodiscard]] std::string expand(size_t line) const;
+    [[nodiscard]] size_t display(size_t line, size_t column) const;
+    void append(std::string_view code);
+    void append(std::string_view code, ThreadPool& pool);
+    // Drops every line and token seen so far. Line numbers keep counting from where they left off.
+    void release() noexcept;
+    void bracket(Token token);
+
+private:
+    void checkGreedy(Token token, const char* left, const char* right, TokenType match);
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,210 @@
+#include "ssa.hpp"
+#include "entity.hpp"
+#include "diagnostics.hpp"
+
+namespace YAOPT {
+
+uint32_t SSA::define(Symbol name, Inst* def) {
+    uint32_t reg = slots.size();
+    slots.push_back({.name = name, .def = def, .parent = reg});
+    return reg;
+}
+
+uint32_t SSA::immediate(Value const& value) {
+    auto [it, inserted] = immediates.try_emplace(value.immediateKey(), slots.size());
+    if (inserted) {
+        slots.push_back({.name = value.literal, .constant = value.constant, .parent = it->second, .immediate = true});
+    }
+    return it->second;
+}
+
+void SSA::use(Value& value, Inst* user, uint32_t reg) {
+    reg = find(reg);
+    value.reg = reg;
+    uint32_t index = uses.size();
+    uses.push_back({.value = &value, .user = user, .next = Value::NONE});
+    auto& slot = slots[reg];
+    (slot.tail == Value::NONE ? slot.head : uses[slot.tail].next) = index;
+    slot.tail = index;
+    ++slot.uses;
+}
+
+uint32_t SSA::find(uint32_t reg) noexcept {
+    uint32_t root = reg;
+    while (slots[root].parent != root) root = slots[root].parent;
+    while (slots[reg].parent != root) reg = std::exchange(slots[reg].parent, root);
+    return root;
+}
+
+Inst* SSA::def(Value const& value) noexcept {
+    return value.reg == Value::NONE ? nullptr : slots[find(value.reg)].def;
+}
+
+void SSA::replaceAllUsesWith(uint32_t from, uint32_t to) noexcept {
+    from = find(from);
+    to = find(to);
+    if (from == to) return;
+    auto& source = slots[from];
+    auto& target = slots[to];
+    if (source.head != Value::NONE) {
+        (target.tail == Value::NONE ? target.head : uses[target.tail].next) = source.head;
+        target.tail = source.tail;
+        target.uses += source.uses;
+    }
+    source.head = source.tail = Value::NONE;
+    source.uses = 0;
+    source.parent = to;
+}
+
+void SSA::drop(Value& value) noexcept {
+    if (value.reg != Value::NONE) {
+        --slots[find(value.reg)].uses;
+        value.reg = Value::NONE;
+    }
+}
+
+void SSA::move(Value& from, Value& to, Inst* user) {
+    uint32_t reg = from.reg;
+    to.literal = from.literal;
+    to.constant = from.constant;
+    to.reg = Value::NONE;
+    if (reg == Value::NONE) return;
+    drop(from);
+    use(to, user, reg);
+}
+
+void SSA::drop(Inst* user) {
+    user->forEachOperand([this](Value& value) { drop(value); });
+}
+
+void SSA::flush() {
+    for (auto&& use : uses) {
+        if (use.value->reg == Value::NONE) continue;
+        uint32_t reg = find(use.value->reg);
+        use.value->literal = slots[reg].name;
+        use.value->constant = slots[reg].constant;
+        use.value->reg = slots[reg].immediate ? Value::NONE : reg;
+    }
+}
+
+void resolve(FunctionDefine& define, std::span<const Segment> where) {
+    auto& ssa = define.ssa;
+    thread_local SymbolMap<std::pair<uint32_t, size_t>> regs;
+    regs.clear();
+    ssa.slots.reserve(define.params.size() + where.size());
+    ssa.uses.reserve(where.size() * 2);
+    auto declare = [&](Symbol name, Inst* def, size_t at) {
+        auto [found, inserted] = regs.try_emplace(name, {ssa.size(), at});
+        if (!inserted) {
+            Error error;
+            error.with(ErrorMessage().error(where[at]).text("redefinition of").quote(name.view()));
+            error.with(ErrorMessage().note(where[found->second]).text("previous definition is here"));
+            error.raise();
+        }
+        return ssa.define(name, def);
+    };
+    thread_local SymbolMap<std::pair<BasicBlock*, size_t>> blocks;
+    blocks.clear();
+    for (auto&& param : define.params) {
+        declare(param.name, nullptr, 0);
+    }
+    size_t at = 0;
+    for (auto bb : define.bbs) {
+        for (auto inst : bb->insts) {
+            ++at;
+            if (inst == bb->labelInst) {
+                auto [found, inserted] = blocks.try_emplace(bb->labelInst->label, {bb, at});
+                if (!inserted) {
+                    Error error;
+                    error.with(ErrorMessage().error(where[at]).text("redefinition of label").quote(bb->label()));
+                    error.with(ErrorMessage().note(where[found->second]).text("previous definition is here"));
+                    error.raise();
+                }
+            }
+            if (inst->kind() != Inst::Kind::INTERMEDIATE) continue;
+            auto intermediate = static_cast<IntermediateInst*>(inst);
+            if (!intermediate->receiver.empty()) {
+                intermediate->number = declare(intermediate->receiver, inst, at);
+            }
+        }
+    }
+    at = 0;
+    for (auto bb : define.bbs) {
+        for (auto inst : bb->insts) {
+            ++at;
+            inst->forEachOperand([&](Value& value) {
+                if (!value.is_reg()) return;
+                auto found = regs.find(value.literal);
+                if (!found) {
+                    Error().with(ErrorMessage().error(where[at]).text("use of undefined value").quote(value.view())).raise();
+                }
+                ssa.use(value, inst, found->first);
+            });
+            if (auto phi = dyn_cast<PhiInst>(inst)) {
+                for (auto&& in : phi->incoming) {
+                    auto found = blocks.find(in.label);
+                    if (!found) {
+                        Error().with(ErrorMessage().error(where[at]).text("use of undefined label").quote(in.label.view())).raise();
+                    }
+                    in.block = found->first;
+                }
+            }
+        }
+        bb->terminatorInst->forEachTarget([&](Symbol& label, BasicBlock*& target) {
+            auto found = blocks.find(label);
+            if (!found) {
+                Error().with(ErrorMessage().error(where[at]).text("use of undefined label").quote(label.view())).raise();
+            }
+            target = found->first;
+        });
+    }
+}
+
+size_t prune(SSA& ssa, PhiInst* phi, FunctionRef<bool(PhiInst::Incoming const&)> keep) {
+    size_t kept = 0;
+    for (auto&& in : phi->incoming) {
+        if (!keep(in)) {
+            ssa.drop(in.value);
+            continue;
+        }
+        auto& slot = phi->incoming[kept++];
+        if (&slot == &in) continue;
+        slot.label = in.label;
+        slot.block = in.block;
+        ssa.move(in.value, slot.value, phi);
+    }
+    size_t removed = phi->incoming.size() - kept;
+    phi->incoming = phi->incoming.first(kept);
+    return removed;
+}
+
+size_t removeBlocks(FunctionDefine& define, FunctionRef<bool(BasicBlock const*)> dead) {
+    std::vector<bool> doomed(define.bbs.size());
+    size_t removed = 0;
+    for (auto bb : define.bbs) {
+        if (dead(bb)) doomed[bb->index] = true, ++removed;
+    }
+    if (!removed) return 0;
+    size_t kept = 0;
+    for (auto bb : define.bbs) {
+        if (doomed[bb->index]) {
+            for (auto inst : bb->insts) define.ssa.drop(inst);
+            continue;
+        }
+        for (auto inst : bb->insts) {
+            if (auto phi = dyn_cast<PhiInst>(inst)) {
+                prune(define.ssa, phi, [&](PhiInst::Incoming const& in) { return !doomed[in.block->index]; });
+            }
+        }
+    }
+    for (auto bb : define.bbs) {
+        if (doomed[bb->index]) continue;
+        bb->index = kept;
+        define.bbs[kept++] = bb;
+    }
+    define.bbs.resize(kept);
+    define.invalidate();
+    return removed;
+}
+
+}
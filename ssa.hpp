@@ -0,0 +1,79 @@
+#pragma once
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "inst.hpp"
+#include "token.hpp"
+
+namespace YAOPT {
+
+struct FunctionDefine;
+
+struct SSA {
+    struct Slot {
+        Symbol name;
+        uint32_t constant = Value::NONE;
+        Inst* def = nullptr;
+        uint32_t parent;
+        uint32_t head = Value::NONE, tail = Value::NONE;
+        uint32_t uses = 0;
+        bool immediate = false;
+
+        [[nodiscard]] uint64_t immediateKey() const noexcept {
+            return constant != Value::NONE ? uint64_t(2) << 32 | constant : uint64_t(1) << 32 | name.id;
+        }
+    };
+
+    struct Use {
+        Value* value;
+        Inst* user;
+        uint32_t next;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<Use> uses;
+    std::unordered_map<uint64_t, uint32_t> immediates;
+
+    [[nodiscard]] size_t size() const noexcept {
+        return slots.size();
+    }
+
+    uint32_t define(Symbol name, Inst* def);
+    // The slot standing for a non-register operand, shared by every operand with the same immediateKey().
+    uint32_t immediate(Value const& value);
+    void use(Value& value, Inst* user, uint32_t reg);
+    uint32_t find(uint32_t reg) noexcept;
+    [[nodiscard]] uint32_t root(uint32_t reg) const noexcept {
+        while (slots[reg].parent != reg) reg = slots[reg].parent;
+        return reg;
+    }
+    [[nodiscard]] Inst* def(Value const& value) noexcept;
+    void replaceAllUsesWith(uint32_t from, uint32_t to) noexcept;
+    void move(Value& from, Value& to, Inst* user);
+    void drop(Value& value) noexcept;
+    void drop(Inst* user);
+    void flush();
+
+    // Use nodes are never unlinked: skip the ones whose operand was dropped or now refers to another value.
+    template<typename F>
+    void forEachUse(uint32_t reg, F&& f) {
+        reg = find(reg);
+        for (uint32_t i = slots[reg].head; i != Value::NONE; i = uses[i].next) {
+            auto value = uses[i].value;
+            if (value->reg != Value::NONE && find(value->reg) == reg) f(uses[i]);
+        }
+    }
+};
+
+void resolve(FunctionDefine& define, std::span<const Segment> where);
+
+// Keeps the phi entries for which `keep` holds, compacting them in place; returns how many were removed.
+size_t prune(SSA& ssa, PhiInst* phi, FunctionRef<bool(PhiInst::Incoming const&)> keep);
+
+// Deletes the blocks for which `dead` holds along with the phi entries flowing in from them, renumbers the
+// remaining blocks and invalidates cached analyses. Returns the number of deleted blocks.
+size_t removeBlocks(FunctionDefine& define, FunctionRef<bool(BasicBlock const*)> dead);
+
+}
@@ -0,0 +1,37 @@
+#include "symbol.hpp"
+
+namespace YAOPT {
+
+namespace {
+
+// Ids are shifted up one place within the shard so that 0 stays the empty symbol.
+constexpr uint32_t FIRST = 1 << ShardedInterner<SymbolTraits>::SHARD_BITS;
+
+ShardedInterner<SymbolTraits>& symbols() {
+    static ShardedInterner<SymbolTraits> symbols;
+    return symbols;
+}
+
+}
+
+Symbol::Symbol(std::string_view text) {
+    if (text.empty()) return;
+    id = symbols().intern(text) + FIRST;
+}
+
+Symbol::Symbol(std::string_view text, SymbolScope& scope) {
+    if (text.empty()) return;
+    id = scope.intern(text) | LOCAL;
+}
+
+std::string_view Symbol::view() const noexcept {
+    if (empty()) return {};
+    if (id & LOCAL) return SymbolScope::at(id & ~LOCAL);
+    return symbols().at(id - FIRST);
+}
+
+size_t symbolCount() noexcept {
+    return symbols().size();
+}
+
+}
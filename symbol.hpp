@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "intern.hpp"
+
+namespace YAOPT {
+
+struct SymbolTraits {
+    using Key = std::string_view;
+    using Hash = std::hash<std::string_view>;
+    using Entry = std::string_view;
+
+    static constexpr const char* WHAT = "too many symbols";
+
+    static std::optional<Entry> make(Key text, Arena& arena) {
+        return copyText(text, arena);
+    }
+    static Key key(Entry const& entry) noexcept {
+        return entry;
+    }
+};
+
+// The names and labels local to one function, freed along with it.
+using SymbolScope = ScopedInterner<SymbolTraits>;
+
+// A global symbol is interned for the whole process; a local one lives in a SymbolScope and is told apart by
+// the LOCAL bit of its id. Equal local symbols of different scopes have different ids.
+struct Symbol {
+    static constexpr uint32_t LOCAL = 1u << 31;
+
+    uint32_t id = 0;
+
+    Symbol() = default;
+    explicit Symbol(std::string_view text);
+    Symbol(std::string_view text, SymbolScope& scope);
+
+    [[nodiscard]] std::string_view view() const noexcept;
+    [[nodiscard]] bool empty() const noexcept {
+        return id == 0;
+    }
+    [[nodiscard]] bool operator==(Symbol const&) const noexcept = default;
+};
+
+// The number of global symbols.
+[[nodiscard]] size_t symbolCount() noexcept;
+
+// Values by local symbol, indexed by scope slot: slots are reused as scopes go away, so they stay dense.
+template<typename T>
+struct SymbolMap {
+    [[nodiscard]] T* find(Symbol symbol) noexcept {
+        uint32_t i = slot(symbol);
+        return i < stamps.size() && stamps[i] == generation ? &values[i] : nullptr;
+    }
+
+    std::pair<T*, bool> try_emplace(Symbol symbol, T value) {
+        if (auto found = find(symbol)) return {found, false};
+        uint32_t i = slot(symbol);
+        if (i >= stamps.size()) {
+            stamps.resize(i + i / 2 + 1);
+            values.resize(stamps.size());
+        }
+        stamps[i] = generation;
+        values[i] = std::move(value);
+        return {&values[i], true};
+    }
+
+    void clear() noexcept {
+        if (++generation == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            generation = 1;
+        }
+    }
+
+private:
+    std::vector<uint32_t> stamps;
+    std::vector<T> values;
+    uint32_t generation = 1;
+
+    [[nodiscard]] static uint32_t slot(Symbol symbol) noexcept {
+        assert(symbol.id & Symbol::LOCAL);
+        return symbol.id & ~Symbol::LOCAL;
+    }
+};
+
+}
+
+template<>
+struct std::hash<YAOPT::Symbol> {
+    size_t operator()(YAOPT::Symbol symbol) const noexcept {
+        return symbol.id * 0x9e3779b97f4a7c15;
+    }
+};
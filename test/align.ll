@@ -0,0 +1,8 @@
+define i64 @f(i64 %a) {
+L0:
+    %p = alloca i64, align 8
+    store i64 %a, ptr %p, align 8
+    %x = load i64, ptr %p, align 8
+    %y = load i64, ptr %p
+    ret i64 %x
+}
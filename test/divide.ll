@@ -0,0 +1,30 @@
+define i64 @quot(i64 %n, i64 %d) {
+entry:
+    br label %head
+head:
+    %i = phi i64 [ 0, %entry ], [ %i2, %latch ]
+    %acc = phi i64 [ 0, %entry ], [ %acc2, %latch ]
+    %c = icmp slt i64 %i, %n
+    br i1 %c, label %test, label %exit
+test:
+    %z = icmp eq i64 %d, 0
+    br i1 %z, label %latch, label %divide
+divide:
+    %q = sdiv i64 100, %d
+    br label %latch
+latch:
+    %v = phi i64 [ 0, %test ], [ %q, %divide ]
+    %acc2 = add i64 %acc, %v
+    %i2 = add i64 %i, 1
+    br label %head
+exit:
+    ret i64 %acc
+}
+
+define i64 @main() {
+entry:
+    %a = call i64 @quot(i64 3, i64 0)
+    %b = call i64 @quot(i64 3, i64 7)
+    %r = add i64 %a, %b
+    ret i64 %r
+}
@@ -0,0 +1,16 @@
+@g = global i64 42
+@h = global double -2.5
+@z = global i64 zeroinitializer
+
+define i64 @main() {
+L0:
+    %a = load i64, ptr @g
+    %b = load double, ptr @h
+    %c = fptosi double %b to i64
+    %d = add i64 %a, %c
+    %z = load i64, ptr @z
+    %e = add i64 %d, %z
+    store i64 %e, ptr @z
+    %f = load i64, ptr @z
+    ret i64 %f
+}
@@ -0,0 +1,25 @@
+define i64 @main() {
+entry:
+    %i = alloca i64
+    %sum = alloca i64
+    store i64 0, ptr %i
+    store i64 0, ptr %sum
+    br label %head
+head:
+    %iv = load i64, ptr %i
+    %c = icmp slt i64 %iv, 10
+    br i1 %c, label %body, label %exit
+body:
+    %sq = mul i64 %iv, %iv
+    %k = mul i64 3, 4
+    %t = add i64 %sq, %k
+    %s = load i64, ptr %sum
+    %s2 = add i64 %s, %t
+    store i64 %s2, ptr %sum
+    %i2 = add i64 %iv, 1
+    store i64 %i2, ptr %i
+    br label %head
+exit:
+    %r = load i64, ptr %sum
+    ret i64 %r
+}
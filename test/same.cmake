@@ -0,0 +1,35 @@
+# Checks that YAOPT prints the same output for INPUT in MODE as it does normally, both with PASSES.
+# MODE stream runs with -stream. MODE cache runs twice against an emptied CACHE directory, with -j2 so
+# that the parallel path is taken too: the first run must miss on every function and the second hit.
+function(yaopt expected)
+    execute_process(COMMAND ${YAOPT} ${PASSES} ${ARGN} -o - ${INPUT}
+            OUTPUT_VARIABLE output ERROR_VARIABLE error RESULT_VARIABLE result)
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "YAOPT ${ARGN} failed with ${result}: ${error}")
+    endif ()
+    if (NOT output STREQUAL expected)
+        message(FATAL_ERROR "YAOPT ${ARGN} printed\n${output}\ninstead of\n${expected}")
+    endif ()
+    set(error "${error}" PARENT_SCOPE)
+endfunction()
+
+execute_process(COMMAND ${YAOPT} ${PASSES} -o - ${INPUT} OUTPUT_VARIABLE expected RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "YAOPT failed with ${result}")
+endif ()
+if (MODE STREQUAL "stream")
+    yaopt("${expected}" -stream)
+elseif (MODE STREQUAL "cache")
+    file(REMOVE_RECURSE ${CACHE})
+    yaopt("${expected}" -j2 -cache=${CACHE})
+    if (NOT error MATCHES "cache: 0 hits, ([1-9][0-9]*) misses")
+        message(FATAL_ERROR "the first run did not miss on every function: ${error}")
+    endif ()
+    set(functions ${CMAKE_MATCH_1})
+    yaopt("${expected}" -j2 -cache=${CACHE})
+    if (NOT error MATCHES "cache: ${functions} hits, 0 misses")
+        message(FATAL_ERROR "the second run did not hit on every function: ${error}")
+    endif ()
+else ()
+    message(FATAL_ERROR "unknown MODE ${MODE}")
+endif ()
@@ -0,0 +1,12 @@
+define i64 @f(i1 %c, ptr %p, ptr %q) {
+entry:
+    store i64 1, ptr %p
+    store i64 2, ptr %q
+    br i1 %c, label %then, label %join
+then:
+    store i64 3, ptr %p
+    br label %join
+join:
+    %x = load i64, ptr %p
+    ret i64 %x
+}
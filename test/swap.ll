@@ -0,0 +1,28 @@
+define i64 @main() {
+entry:
+    %a = alloca i64
+    %b = alloca i64
+    %n = alloca i64
+    store i64 1, ptr %a
+    store i64 2, ptr %b
+    store i64 0, ptr %n
+    br label %head
+head:
+    %nv = load i64, ptr %n
+    %c = icmp slt i64 %nv, 5
+    br i1 %c, label %body, label %exit
+body:
+    %av = load i64, ptr %a
+    %bv = load i64, ptr %b
+    store i64 %bv, ptr %a
+    store i64 %av, ptr %b
+    %n2 = add i64 %nv, 1
+    store i64 %n2, ptr %n
+    br label %head
+exit:
+    %x = load i64, ptr %a
+    %y = load i64, ptr %b
+    %x10 = mul i64 %x, 10
+    %r = add i64 %x10, %y
+    ret i64 %r
+}
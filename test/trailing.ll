@@ -0,0 +1,5 @@
+define i64 @f(i64 %a) {
+L0:
+    %x = add i64 %a, 1 garbage here
+    ret i64 %x
+}
@@ -1,11 +1,15 @@
 #pragma once
 
-#include <unordered_map>
+#include <array>
+#include <cstdint>
 #include <string_view>
+#include <vector>
+
+#include "keyword.hpp"
 
 namespace YAOPT {
 
-enum class TokenType {
+enum class TokenType : uint8_t {
     INVALID,
 
     IDENTIFIER,
@@ -28,20 +32,22 @@ enum class TokenType {
     FLOATING_POINT
 };
 
-const std::unordered_map<std::string_view, TokenType> PUNCTUATIONS {
-    {"=", TokenType::OP_ASSIGN},
-    {"*", TokenType::OP_STAR},
-    {"%", TokenType::OP_PERCENT},
-    {".", TokenType::OP_DOT},
-    {",", TokenType::OP_COMMA},
-    {":", TokenType::OP_COLON},
-    {"(", TokenType::LPAREN},
-    {")", TokenType::RPAREN},
-    {"[", TokenType::LBRACKET},
-    {"]", TokenType::RBRACKET},
-    {"{", TokenType::LBRACE},
-    {"}", TokenType::RBRACE},
-};
+constexpr std::array<TokenType, 256> PUNCTUATIONS = [] {
+    std::array<TokenType, 256> table{};
+    table['='] = TokenType::OP_ASSIGN;
+    table['*'] = TokenType::OP_STAR;
+    table['%'] = TokenType::OP_PERCENT;
+    table['.'] = TokenType::OP_DOT;
+    table[','] = TokenType::OP_COMMA;
+    table[':'] = TokenType::OP_COLON;
+    table['('] = TokenType::LPAREN;
+    table[')'] = TokenType::RPAREN;
+    table['['] = TokenType::LBRACKET;
+    table[']'] = TokenType::RBRACKET;
+    table['{'] = TokenType::LBRACE;
+    table['}'] = TokenType::RBRACE;
+    return table;
+}();
 
 struct Segment {
     size_t line1, line2, column1, column2;
@@ -50,6 +56,7 @@ struct Segment {
 struct Token {
     size_t line, column, width;
     TokenType type;
+    Keyword keyword = Keyword::NONE;
 
     operator Segment() const noexcept {
         return {.line1 = line, .line2 = line, .column1 = column, .column2 = column + width};
@@ -64,4 +71,89 @@ inline Segment range(Segment from, Segment to) noexcept {
     return {.line1 = from.line1, .line2 = to.line2, .column1 = from.column1, .column2 = to.column2};
 }
 
-}
\ No newline at end of file
+struct TokenLine;
+
+struct TokenStream {
+    std::vector<uint32_t> columns;
+    std::vector<uint16_t> widths;
+    std::vector<TokenType> types;
+    std::vector<Keyword> keywords;
+    std::vector<uint32_t> lines;
+    std::vector<uint32_t> starts{0};
+
+    [[nodiscard]] size_t size() const noexcept {
+        return lines.size();
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return lines.empty();
+    }
+    [[nodiscard]] Token at(size_t line, size_t index) const noexcept {
+        return {.line = line, .column = columns[index], .width = widths[index], .type = types[index], .keyword = keywords[index]};
+    }
+    [[nodiscard]] TokenLine operator[](size_t index) const noexcept;
+
+    void open(size_t line) {
+        lines.push_back(line);
+    }
+    void push(Token token) {
+        columns.push_back(token.column);
+        widths.push_back(token.width);
+        types.push_back(token.type);
+        keywords.push_back(token.keyword);
+    }
+    void close() {
+        if (columns.size() == starts.back()) {
+            lines.pop_back();
+        } else {
+            starts.push_back(columns.size());
+        }
+    }
+    // Empties the stream but keeps its capacity for the lines that come next.
+    void clear() noexcept {
+        columns.clear();
+        widths.clear();
+        types.clear();
+        keywords.clear();
+        lines.clear();
+        starts.resize(1);
+    }
+    void append(TokenStream const& other) {
+        uint32_t offset = columns.size();
+        columns.insert(columns.end(), other.columns.begin(), other.columns.end());
+        widths.insert(widths.end(), other.widths.begin(), other.widths.end());
+        types.insert(types.end(), other.types.begin(), other.types.end());
+        keywords.insert(keywords.end(), other.keywords.begin(), other.keywords.end());
+        lines.insert(lines.end(), other.lines.begin(), other.lines.end());
+        for (size_t i = 1; i < other.starts.size(); ++i) {
+            starts.push_back(other.starts[i] + offset);
+        }
+    }
+};
+
+struct TokenLine {
+    TokenStream const* stream;
+    size_t line;
+    uint32_t first, last;
+
+    [[nodiscard]] size_t size() const noexcept {
+        return last - first;
+    }
+    [[nodiscard]] bool empty() const noexcept {
+        return first == last;
+    }
+    [[nodiscard]] Token operator[](size_t index) const noexcept {
+        return stream->at(line, first + index);
+    }
+    [[nodiscard]] Token front() const noexcept {
+        return (*this)[0];
+    }
+    [[nodiscard]] Token back() const noexcept {
+        return (*this)[size() - 1];
+    }
+};
+
+inline TokenLine TokenStream::operator[](size_t index) const noexcept {
+    return {.stream = this, .line = lines[index], .first = starts[index], .last = starts[index + 1]};
+}
+
+}
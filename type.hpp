@@ -0,0 +1,23 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+#include "keyword.hpp"
+
+namespace YAOPT {
+
+enum class Type {
+    VOID, I1, I64, DOUBLE, PTR, LABEL
+};
+
+[[nodiscard]] constexpr std::optional<Type> typeOf(Keyword keyword) noexcept {
+    if (keyword < Keyword::VOID || keyword > Keyword::LABEL) return std::nullopt;
+    return Type(size_t(keyword) - size_t(Keyword::VOID));
+}
+
+[[nodiscard]] constexpr std::string_view nameOf(Type type) noexcept {
+    return KEYWORD_NAME[size_t(Keyword::VOID) + size_t(type)];
+}
+
+}
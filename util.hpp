@@ -3,6 +3,10 @@
 #include <cstdio>
 #include <string>
 #include <vector>
+#include <type_traits>
+#include <utility>
+
+#include "scan.hpp"
 
 namespace YAOPT {
 
@@ -27,27 +31,54 @@ inline void forceUTF8() {
 
 inline std::vector<std::string_view> splitLines(std::string_view view) {
     std::vector<std::string_view> lines;
+    auto& scan = scanner();
     const char *p = view.begin(), *q = p;
-    while (q != view.end()) {
-        if (*q == '\n' || *q == '\r') {
-            lines.emplace_back(p, q);
-            if (q[0] == '\r' && q[1] == '\n') {
-                ++q;
-            }
-            p = ++q;
-        } else {
+    while ((q = scan.findLineBreak(q, view.end())) != view.end()) {
+        lines.emplace_back(p, q);
+        if (q[0] == '\r' && q + 1 != view.end() && q[1] == '\n') {
             ++q;
         }
+        p = ++q;
     }
     lines.emplace_back(p, q);
     return lines;
 }
 
+// Removes the first line from `view` and returns it without its line break.
+inline std::string_view nextLine(std::string_view& view) {
+    const char *p = view.begin(), *q = scanner().findLineBreak(p, view.end());
+    std::string_view line(p, q);
+    if (q != view.end()) {
+        if (q[0] == '\r' && q + 1 != view.end() && q[1] == '\n') ++q;
+        ++q;
+    }
+    view = {q, view.end()};
+    return line;
+}
+
 [[noreturn]] inline void unreachable() {
     __builtin_unreachable();
 }
 
 
+template<typename Signature>
+struct FunctionRef;
+
+template<typename R, typename... Args>
+struct FunctionRef<R(Args...)> {
+    void* object;
+    R (*call)(void*, Args...);
+
+    template<typename F>
+    FunctionRef(F&& f) noexcept:
+            object(const_cast<void*>(static_cast<const void*>(&f))),
+            call([](void* o, Args... args) -> R { return (*static_cast<std::remove_reference_t<F>*>(o))(std::forward<Args>(args)...); }) {}
+
+    R operator()(Args... args) const {
+        return call(object, std::forward<Args>(args)...);
+    }
+};
+
 template<typename... Args>
 inline std::string join(Args&&... args) {
     std::string result;